@@ -58,6 +58,29 @@ public:
 	/// \return true, if the entry was found, false else
 	bool get( const char* key, NodeData& val) const;
 
+	/// \brief Get the root node address as start of a stepwise traversal of the trie with 'successor'
+	/// \return the root node address or 0, if the trie is empty
+	NodeAddress rootaddr() const
+	{
+		return m_rootaddr;
+	}
+
+	/// \brief Get the node following a node with a character in a stepwise traversal of the trie
+	/// \param[in] addr virtual address of the current node
+	/// \param[in] chr character to follow
+	/// \return the address of the successor node or 0, if it does not exist
+	NodeAddress successor( const NodeAddress& addr, unsigned char chr) const
+	{
+		return (chr == 0xFF || chr == 0 || !addr) ? 0 : successorNodeAddress( addr, chr);
+		//... 0xFF is reserved as end of key marker and 0 as key terminator
+	}
+
+	/// \brief Get the value of the key ending in a node visited in a stepwise traversal of the trie
+	/// \param[in] addr virtual address of the node
+	/// \param[out] val the value assigned to the key ending in the node
+	/// \return true, if a key ends in this node, false else
+	bool getData( const NodeAddress& addr, NodeData& val) const;
+
 	/// \class const_iterator
 	/// \brief Read only iterator on the trie
 	class const_iterator
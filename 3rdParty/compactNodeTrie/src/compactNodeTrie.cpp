@@ -189,6 +189,25 @@ bool CompactNodeTrie::get( const char* key, NodeData& val) const
 	}
 }
 
+bool CompactNodeTrie::getData( const NodeAddress& addr_, NodeData& val) const
+{
+	if (!addr_) return false;
+	if (nodeClassId(addr_) == NodeClass::NodeData)
+	{
+		val = m_datablock[ nodeIndex( addr_)];
+		return true;
+	}
+	NodeAddress addr = successorNodeAddress( addr_, 0xFF);
+	if (!addr) return false;
+
+	if (nodeClassId(addr) != NodeClass::NodeData)
+	{
+		throw std::runtime_error( "currupt data (non UTF-8 string inserted)");
+	}
+	val = m_datablock[ nodeIndex( addr)];
+	return true;
+}
+
 CompactNodeTrie::const_iterator::const_iterator( const CompactNodeTrie* tree_, NodeAddress rootaddr)
 	:m_tree(tree_)
 {
@@ -9,7 +9,10 @@
 /// \file error.hpp
 #ifndef _STRUS_PATTERN_LIB_HPP_INCLUDED
 #define _STRUS_PATTERN_LIB_HPP_INCLUDED
+#include "strus/analyzer/positionBind.hpp"
 #include <cstdio>
+#include <string>
+#include <vector>
 
 /// \brief strus toplevel namespace
 namespace strus {
@@ -22,6 +25,22 @@ class PatternMatcherInterface;
 class TokenMarkupInstanceInterface;
 /// \brief Forward declaration
 class ErrorBufferInterface;
+/// \brief Forward declaration
+class PatternLexerContextInterface;
+/// \brief Forward declaration
+class PatternMatcherContextInterface;
+/// \brief Forward declaration
+class PatternLexemBatch;
+/// \brief Forward declaration
+class PatternLexerInstanceInterface;
+/// \brief Forward declaration
+class PatternMatcherInstanceInterface;
+namespace analyzer {
+/// \brief Forward declaration
+class PatternMatcherResult;
+/// \brief Forward declaration
+class PatternLexem;
+}
 
 /// \brief Create the interface for regular expression matching on text
 PatternLexerInterface* createPatternLexer_stream(
@@ -31,6 +50,273 @@ PatternLexerInterface* createPatternLexer_stream(
 PatternMatcherInterface* createPatternMatcher_stream(
 		ErrorBufferInterface* errorhnd);
 
+/// \brief Define a lexem as logical combination of other lexems, evaluated by the lexer instead of a pattern matcher rule
+/// \param[in] lexer lexer instance to define the lexem in
+/// \param[in] id identifier given to the lexem
+/// \param[in] expression logical expression with the operators '&' (and), '|' (or), '!' (not) and brackets on the identifiers of lexems defined, e.g. "(12 | 13) & !14"
+/// \param[in] span maximum distance in bytes from the start of the first to the end of the last match of the lexems combined, at most 16384
+/// \param[in] level priority of the lexem in case of overlapping matches
+/// \param[in] posbind defines how the ordinal position of the lexem is assigned
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for lexers created with createPatternLexer_stream
+/// \remark A combination is evaluated at the end of every match of a lexem combined, taking only the matches starting at most 'span' bytes before into account. It must not be true without any match of a lexem combined.
+bool definePatternLexemCombination(
+		PatternLexerInstanceInterface* lexer,
+		unsigned int id,
+		const std::string& expression,
+		unsigned int span,
+		unsigned int level,
+		analyzer::PositionBind posbind,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Get the identifiers of all terms a compiled pattern matcher reacts on
+/// \param[out] dest where to write the term identifiers to (in ascending order)
+/// \param[in] matcher compiled pattern matcher instance
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for pattern matchers created with createPatternMatcher_stream
+bool getPatternMatcherReferencedTerms(
+		std::vector<unsigned int>& dest,
+		const PatternMatcherInstanceInterface* matcher,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Declare the lexems referenced by the consumer of the lexems (e.g. the terms returned by getPatternMatcherReferencedTerms), other lexems are left out if they can neither influence the ordinal positions nor supersede a lexem reported
+/// \param[in] lexer lexer instance not compiled yet
+/// \param[in] ids identifiers of the lexems referenced
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for lexers created with createPatternLexer_stream
+bool definePatternLexerReferencedLexems(
+		PatternLexerInstanceInterface* lexer,
+		const std::vector<unsigned int>& ids,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Get the identifiers of all lexems and symbols a lexer can produce
+/// \param[out] dest where to write the identifiers to (in ascending order)
+/// \param[in] lexer lexer instance
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for lexers created with createPatternLexer_stream
+bool getPatternLexerVocabulary(
+		std::vector<unsigned int>& dest,
+		const PatternLexerInstanceInterface* lexer,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Declare the terms that can occur in the input of a pattern matcher (e.g. the result of getPatternLexerVocabulary), programs that can never be triggered are removed on compile
+/// \param[in] matcher pattern matcher instance not compiled yet
+/// \param[in] termids identifiers of the terms that can occur
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for pattern matchers created with createPatternMatcher_stream
+bool definePatternMatcherTermVocabulary(
+		PatternMatcherInstanceInterface* matcher,
+		const std::vector<unsigned int>& termids,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Get the binary image of a compiled pattern matcher, that can be stored and loaded instead of defining and compiling the patterns again
+/// \param[out] dest where to write the image to
+/// \param[in] matcher compiled pattern matcher instance
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for pattern matchers created with createPatternMatcher_stream
+bool getPatternMatcherImage(
+		std::string& dest,
+		const PatternMatcherInstanceInterface* matcher,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Load a pattern matcher instance from a binary image created with getPatternMatcherImage
+/// \param[in] matcher pattern matcher instance without patterns defined
+/// \param[in] image pointer to the image aligned to 8 bytes (e.g. a file mapped read only into memory), the image is not copied and has to stay valid as long as the matcher and its contexts are used
+/// \param[in] imagesize size of the image in bytes
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for pattern matchers created with createPatternMatcher_stream, the image has to be created on a host with the same byte order and structure layout
+bool loadPatternMatcherImage(
+		PatternMatcherInstanceInterface* matcher,
+		const char* image,
+		std::size_t imagesize,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Load a pattern matcher instance from a file with a binary image created with getPatternMatcherImage
+/// \param[in] matcher pattern matcher instance without patterns defined
+/// \param[in] path path of the image file, mapped read only into memory for the lifetime of the matcher
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note The pages of the mapping are shared by all processes loading the same file (e.g. worker processes forked from a server), only the state of the matcher contexts is private
+bool loadPatternMatcherImageFile(
+		PatternMatcherInstanceInterface* matcher,
+		const std::string& path,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Restrict the lexems reported by a lexer context to a subset, so that contexts of different users can share one compiled lexer
+/// \param[in] ctx lexer context to restrict
+/// \param[in] enabledIds identifiers of the lexems reported by following calls of match, no lexems are reported if empty
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for lexer contexts created by lexers of createPatternLexer_stream
+/// \remark Use clearPatternLexerContextLexemMask to report all lexems again
+bool setPatternLexerContextLexemMask(
+		PatternLexerContextInterface* ctx,
+		const std::vector<unsigned int>& enabledIds,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Remove the restriction of the lexems reported by a lexer context defined with setPatternLexerContextLexemMask
+/// \param[in] ctx lexer context to reset
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for lexer contexts created by lexers of createPatternLexer_stream
+bool clearPatternLexerContextLexemMask(
+		PatternLexerContextInterface* ctx,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Detect all tokens in a text and write them as columnar batch
+/// \param[out] dest where to write the result to
+/// \param[in] ctx lexer context to use
+/// \param[in] src pointer to text to scan
+/// \param[in] srclen size of text to scan in bytes
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+bool matchPatternLexemBatch(
+		PatternLexemBatch& dest,
+		PatternLexerContextInterface* ctx,
+		const char* src,
+		std::size_t srclen,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Start matching a text fed in chunks, discards the state of a text not closed
+/// \param[in] ctx lexer context to use
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for lexer contexts created by lexers of createPatternLexer_stream compiled with the option "STREAM"
+bool openPatternLexerStream(
+		PatternLexerContextInterface* ctx,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Feed the next chunk of a text opened with openPatternLexerStream
+/// \param[out] dest where to append the lexems not affected by the following chunks to
+/// \param[in] ctx lexer context to use
+/// \param[in] chunk pointer to the chunk, may split UTF-8 characters
+/// \param[in] chunksize size of the chunk in bytes
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+bool feedPatternLexerStream(
+		std::vector<analyzer::PatternLexem>& dest,
+		PatternLexerContextInterface* ctx,
+		const char* chunk,
+		std::size_t chunksize,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Terminate matching a text opened with openPatternLexerStream
+/// \param[out] dest where to append the remaining lexems to
+/// \param[in] ctx lexer context to use
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+bool closePatternLexerStream(
+		std::vector<analyzer::PatternLexem>& dest,
+		PatternLexerContextInterface* ctx,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Callback reading the next chunk of a text to match
+/// \param[in] reader object of the reader passed to matchPatternLexerStream
+/// \param[out] buf where to write the chunk read to
+/// \param[in] bufsize size of the buffer in bytes
+/// \param[out] readsize number of bytes read, 0 at the end of the text
+/// \return true on success, false on error
+typedef bool (*PatternLexerChunkReader)( void* reader, char* buf, std::size_t bufsize, std::size_t& readsize);
+
+/// \brief Detect all tokens in a text read in chunks, e.g. from a file or a decompressor provided by the caller
+/// \param[out] dest where to append the lexems matched to
+/// \param[in] ctx lexer context to use
+/// \param[in] readChunk callback reading the next chunk of the text
+/// \param[in] reader object passed to the callback
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for lexer contexts created by lexers of createPatternLexer_stream compiled with the option "STREAM", the callback is called by a separate thread reading ahead while the chunks read before are matched
+bool matchPatternLexerStream(
+		std::vector<analyzer::PatternLexem>& dest,
+		PatternLexerContextInterface* ctx,
+		PatternLexerChunkReader readChunk,
+		void* reader,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Feed a columnar batch of lexems to a pattern matcher context
+/// \param[in] ctx pattern matcher context to use
+/// \param[in] batch lexems to feed
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+bool putInputPatternLexemBatch(
+		PatternMatcherContextInterface* ctx,
+		const PatternLexemBatch& batch,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Feed an array of lexems to a pattern matcher context with one call
+/// \param[in] ctx pattern matcher context to use
+/// \param[in] ar pointer to the lexems in ascending order of their ordinal position
+/// \param[in] size number of lexems
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note For contexts of pattern matchers created with createPatternMatcher_stream the lexems are validated once and fed without a call per lexem
+bool putInputPatternLexems(
+		PatternMatcherContextInterface* ctx,
+		const analyzer::PatternLexem* ar,
+		std::size_t size,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Match a list of documents in parallel with one compiled pattern matcher
+/// \param[out] results the results of each document in the order of the documents
+/// \param[in] matcher compiled pattern matcher instance
+/// \param[in] documents the lexems of each document in ascending order of their ordinal position
+/// \param[in] nofThreads number of threads to use, 0 for the number of cores of the host
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for pattern matchers created with createPatternMatcher_stream, the documents are distributed on a pool of threads balancing the load by work stealing
+bool matchPatternMatcherDocuments(
+		std::vector<std::vector<analyzer::PatternMatcherResult> >& results,
+		const PatternMatcherInstanceInterface* matcher,
+		const std::vector<PatternLexemBatch>& documents,
+		unsigned int nofThreads,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Match one long document in parallel with one compiled pattern matcher, splitting it into windows of ordinal positions
+/// \param[out] results the results of the document, the same as when matched sequentially with one context
+/// \param[in] matcher compiled pattern matcher instance
+/// \param[in] document the lexems of the document in ascending order of their ordinal position
+/// \param[in] nofThreads number of threads to use, 0 for the number of cores of the host
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+/// \note Only available for pattern matchers created with createPatternMatcher_stream, documents too small to be split are matched sequentially
+bool matchPatternMatcherDocumentParallel(
+		std::vector<analyzer::PatternMatcherResult>& results,
+		const PatternMatcherInstanceInterface* matcher,
+		const PatternLexemBatch& document,
+		unsigned int nofThreads,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Serialize a columnar batch of lexems, e.g. for caching lexed documents on disk
+/// \param[out] dest where to append the binary image to
+/// \param[in] batch lexems to serialize
+/// \param[in] deltaEncoding true, if positions should be stored delta encoded
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+bool serializePatternLexemBatch(
+		std::string& dest,
+		const PatternLexemBatch& batch,
+		bool deltaEncoding,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Deserialize a columnar batch of lexems from its binary image
+/// \param[out] dest where to append the lexems to
+/// \param[in] src pointer to the binary image
+/// \param[in] srcsize size of the binary image in bytes
+/// \param[in] errorhnd error buffer interface
+/// \return true on success, false on error
+bool deserializePatternLexemBatch(
+		PatternLexemBatch& dest,
+		const char* src,
+		std::size_t srcsize,
+		ErrorBufferInterface* errorhnd);
+
 }//namespace
 #endif
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2017 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Columnar representation of a sequence of lexems passed from the lexer to the pattern matcher
+/// \file patternLexemBatch.hpp
+#ifndef _STRUS_PATTERN_LEXEM_BATCH_HPP_INCLUDED
+#define _STRUS_PATTERN_LEXEM_BATCH_HPP_INCLUDED
+#include "strus/analyzer/patternLexem.hpp"
+#include "strus/base/stdint.h"
+#include <vector>
+#include <cstddef>
+
+/// \brief strus toplevel namespace
+namespace strus {
+
+/// \brief Sequence of lexems stored as separate arrays per attribute (columns) instead of an array of analyzer::PatternLexem structures
+/// \remark Use the functions serializePatternLexemBatch and deserializePatternLexemBatch declared in "strus/lib/pattern.hpp" to store a batch
+class PatternLexemBatch
+{
+public:
+	/// \brief Default constructor
+	PatternLexemBatch()
+		:m_idar(),m_ordposar(),m_origsegar(),m_origposar(),m_origsizear(){}
+	/// \brief Copy constructor
+	PatternLexemBatch( const PatternLexemBatch& o)
+		:m_idar(o.m_idar),m_ordposar(o.m_ordposar),m_origsegar(o.m_origsegar),m_origposar(o.m_origposar),m_origsizear(o.m_origsizear){}
+
+	/// \brief Remove all elements
+	void clear()
+	{
+		m_idar.clear();
+		m_ordposar.clear();
+		m_origsegar.clear();
+		m_origposar.clear();
+		m_origsizear.clear();
+	}
+
+	/// \brief Reserve space for a number of elements
+	void reserve( std::size_t nofElements)
+	{
+		m_idar.reserve( nofElements);
+		m_ordposar.reserve( nofElements);
+		m_origsegar.reserve( nofElements);
+		m_origposar.reserve( nofElements);
+		m_origsizear.reserve( nofElements);
+	}
+
+	/// \brief Append one lexem
+	void push_back( unsigned int id, unsigned int ordpos, uint32_t origseg, uint32_t origpos, uint32_t origsize)
+	{
+		m_idar.push_back( id);
+		m_ordposar.push_back( ordpos);
+		m_origsegar.push_back( origseg);
+		m_origposar.push_back( origpos);
+		m_origsizear.push_back( origsize);
+	}
+
+	/// \brief Append one lexem
+	void push_back( const analyzer::PatternLexem& lexem)
+	{
+		push_back( lexem.id(), lexem.ordpos(), (uint32_t)lexem.origseg(), (uint32_t)lexem.origpos(), (uint32_t)lexem.origsize());
+	}
+
+	/// \brief Get the number of lexems
+	std::size_t size() const		{return m_idar.size();}
+	/// \brief Test if the batch is empty
+	bool empty() const			{return m_idar.empty();}
+
+	/// \brief Get a lexem by index
+	analyzer::PatternLexem operator[]( std::size_t idx) const
+	{
+		return analyzer::PatternLexem( m_idar[ idx], m_ordposar[ idx], m_origsegar[ idx], m_origposar[ idx], m_origsizear[ idx]);
+	}
+
+	/// \brief Get the array of lexem identifiers
+	const std::vector<uint32_t>& idar() const		{return m_idar;}
+	/// \brief Get the array of ordinal positions
+	const std::vector<uint32_t>& ordposar() const		{return m_ordposar;}
+	/// \brief Get the array of original segment indices
+	const std::vector<uint32_t>& origsegar() const		{return m_origsegar;}
+	/// \brief Get the array of original byte positions in a segment
+	const std::vector<uint32_t>& origposar() const		{return m_origposar;}
+	/// \brief Get the array of original sizes in bytes
+	const std::vector<uint32_t>& origsizear() const		{return m_origsizear;}
+
+private:
+	std::vector<uint32_t> m_idar;
+	std::vector<uint32_t> m_ordposar;
+	std::vector<uint32_t> m_origsegar;
+	std::vector<uint32_t> m_origposar;
+	std::vector<uint32_t> m_origsizear;
+};
+
+}//namespace
+#endif
+
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2017 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+///\brief Writer and reader of binary images of arrays of POD structures, readable in place (e.g. from a file mapped into memory)
+#ifndef _STRUS_PATTERN_BINARY_IMAGE_HPP_INCLUDED
+#define _STRUS_PATTERN_BINARY_IMAGE_HPP_INCLUDED
+#include "strus/base/stdint.h"
+#include "internationalization.hpp"
+#include "errorUtils.hpp"
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <limits>
+
+namespace strus
+{
+
+/// \brief Image layout: every array is stored as a header of two 32 bit words (element size, number of elements) followed by the elements,
+///	the headers and the elements are aligned to BinaryImageAlignment bytes relative to the start of the image.
+///	The image uses the byte order and the structure layout of the host, the header of the image is responsible for rejecting images built for other hosts.
+enum {BinaryImageAlignment=8};
+
+class BinaryImageWriter
+{
+public:
+	explicit BinaryImageWriter( std::string& dest_)
+		:m_dest(dest_),m_start(dest_.size()){}
+
+	void writeUint32( uint32_t val)
+	{
+		m_dest.append( (const char*)&val, sizeof(val));
+	}
+
+	template <typename ELEMTYPE>
+	void writeArray( const ELEMTYPE* ar, std::size_t size)
+	{
+		if (size >= (std::size_t)std::numeric_limits<uint32_t>::max())
+		{
+			throw strus::runtime_error(_TXT("array too big for binary image"));
+		}
+		align();
+		writeUint32( sizeof(ELEMTYPE));
+		writeUint32( (uint32_t)size);
+		align();
+		if (size) m_dest.append( (const char*)(const void*)ar, size * sizeof(ELEMTYPE));
+	}
+
+	void align()
+	{
+		std::size_t pos = m_dest.size() - m_start;
+		if (pos % BinaryImageAlignment) m_dest.append( BinaryImageAlignment - (pos % BinaryImageAlignment), '\0');
+	}
+
+private:
+	std::string& m_dest;
+	std::size_t m_start;
+};
+
+class BinaryImageReader
+{
+public:
+	/// \brief Constructor
+	/// \param[in] src pointer to the image, must be aligned to BinaryImageAlignment bytes
+	/// \param[in] srcsize size of the image in bytes
+	BinaryImageReader( const char* src, std::size_t srcsize)
+		:m_start(src),m_itr(src),m_end(src+srcsize)
+	{
+		if (((uintptr_t)src) % BinaryImageAlignment != 0)
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("image not aligned"));
+		}
+	}
+
+	uint32_t readUint32()
+	{
+		if (m_itr + sizeof(uint32_t) > m_end)
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("unexpected end of image"));
+		}
+		uint32_t rt;
+		std::memcpy( &rt, m_itr, sizeof(rt));
+		m_itr += sizeof(rt);
+		return rt;
+	}
+
+	/// \brief Get a pointer to an array in the image (not copied)
+	template <typename ELEMTYPE>
+	const ELEMTYPE* readArray( uint32_t& size)
+	{
+		align();
+		uint32_t elemsize = readUint32();
+		size = readUint32();
+		if (elemsize != sizeof(ELEMTYPE))
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("element size does not match"));
+		}
+		align();
+		if ((std::size_t)(m_end - m_itr) / sizeof(ELEMTYPE) < size)
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("array size out of range"));
+		}
+		const ELEMTYPE* rt = (const ELEMTYPE*)(const void*)m_itr;
+		m_itr += size * sizeof(ELEMTYPE);
+		return rt;
+	}
+
+	bool eof() const
+	{
+		return m_itr >= m_end;
+	}
+
+private:
+	void align()
+	{
+		std::size_t pos = m_itr - m_start;
+		if (pos % BinaryImageAlignment) m_itr += BinaryImageAlignment - (pos % BinaryImageAlignment);
+		if (m_itr > m_end) m_itr = m_end;
+	}
+
+private:
+	const char* m_start;
+	const char* m_itr;
+	const char* m_end;
+};
+
+}//namespace
+#endif
+
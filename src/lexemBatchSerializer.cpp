@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2017 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Binary serialization of columnar lexem batches
+/// \file "lexemBatchSerializer.cpp"
+#include "lexemBatchSerializer.hpp"
+#include "internationalization.hpp"
+#include <vector>
+#include <limits>
+#include <cstring>
+
+using namespace strus;
+
+/// \brief Image layout:
+///	4 bytes magic "SPLB", 1 byte version, 1 byte flags (bit 0: delta encoding),
+///	varint number of elements, followed by the columns id, ordpos, origseg, origpos, origsize each as varints.
+///	With delta encoding the columns ordpos, origseg and origpos are stored as zigzag encoded differences to their predecessor.
+#define LEXEM_BATCH_MAGIC "SPLB"
+enum {LexemBatchVersion=1, LexemBatchFlagDelta=0x1};
+
+static void packVarint( std::string& dest, uint32_t val)
+{
+	while (val >= 0x80)
+	{
+		dest.push_back( (char)(unsigned char)((val & 0x7F) | 0x80));
+		val >>= 7;
+	}
+	dest.push_back( (char)(unsigned char)val);
+}
+
+static uint32_t unpackVarint( char const*& si, const char* se)
+{
+	uint32_t rt = 0;
+	unsigned int shift = 0;
+	for (;;)
+	{
+		if (si == se || shift > 28)
+		{
+			throw strus::runtime_error(_TXT("corrupt lexem batch image: %s"), _TXT("bad integer encoding"));
+		}
+		unsigned char ch = (unsigned char)*si++;
+		rt |= (uint32_t)(ch & 0x7F) << shift;
+		if ((ch & 0x80) == 0) return rt;
+		shift += 7;
+	}
+}
+
+static inline uint32_t zigzagEncode( uint32_t val, uint32_t prev)
+{
+	int32_t diff = (int32_t)(val - prev);
+	return ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
+}
+
+static inline uint32_t zigzagDecode( uint32_t code, uint32_t prev)
+{
+	uint32_t diff = (code >> 1) ^ (uint32_t)-(int32_t)(code & 1);
+	return prev + diff;
+}
+
+static void packColumn( std::string& dest, const std::vector<uint32_t>& column, bool deltaEncoding)
+{
+	std::vector<uint32_t>::const_iterator ci = column.begin(), ce = column.end();
+	uint32_t prev = 0;
+	for (; ci != ce; ++ci)
+	{
+		if (deltaEncoding)
+		{
+			packVarint( dest, zigzagEncode( *ci, prev));
+			prev = *ci;
+		}
+		else
+		{
+			packVarint( dest, *ci);
+		}
+	}
+}
+
+static void unpackColumn( std::vector<uint32_t>& column, std::size_t size, char const*& si, const char* se, bool deltaEncoding)
+{
+	column.reserve( size);
+	uint32_t prev = 0;
+	std::size_t ci = 0;
+	for (; ci < size; ++ci)
+	{
+		uint32_t val = unpackVarint( si, se);
+		if (deltaEncoding)
+		{
+			val = prev = zigzagDecode( val, prev);
+		}
+		column.push_back( val);
+	}
+}
+
+void strus::serializeLexemBatch( std::string& dest, const PatternLexemBatch& batch, bool deltaEncoding)
+{
+	if (batch.size() >= (std::size_t)std::numeric_limits<uint32_t>::max())
+	{
+		throw strus::runtime_error(_TXT("lexem batch too big for serialization"));
+	}
+	dest.reserve( dest.size() + 8 + batch.size() * 6);
+	dest.append( LEXEM_BATCH_MAGIC);
+	dest.push_back( (char)LexemBatchVersion);
+	dest.push_back( (char)(deltaEncoding ? LexemBatchFlagDelta : 0));
+	packVarint( dest, (uint32_t)batch.size());
+
+	packColumn( dest, batch.idar(), false);
+	packColumn( dest, batch.ordposar(), deltaEncoding);
+	packColumn( dest, batch.origsegar(), deltaEncoding);
+	packColumn( dest, batch.origposar(), deltaEncoding);
+	packColumn( dest, batch.origsizear(), false);
+}
+
+void strus::deserializeLexemBatch( PatternLexemBatch& dest, const char* src, std::size_t srcsize)
+{
+	char const* si = src;
+	const char* se = src + srcsize;
+	std::size_t magiclen = std::strlen( LEXEM_BATCH_MAGIC);
+	if (srcsize < magiclen + 2 || 0!=std::memcmp( si, LEXEM_BATCH_MAGIC, magiclen))
+	{
+		throw strus::runtime_error(_TXT("corrupt lexem batch image: %s"), _TXT("unknown format"));
+	}
+	si += magiclen;
+	if (*si++ != (char)LexemBatchVersion)
+	{
+		throw strus::runtime_error(_TXT("corrupt lexem batch image: %s"), _TXT("unsupported version"));
+	}
+	unsigned char flags = (unsigned char)*si++;
+	bool deltaEncoding = (flags & LexemBatchFlagDelta) != 0;
+	std::size_t size = unpackVarint( si, se);
+	if (size > (std::size_t)(se - si) / 5)
+	{
+		throw strus::runtime_error(_TXT("corrupt lexem batch image: %s"), _TXT("size out of range"));
+	}
+	std::vector<uint32_t> idar, ordposar, origsegar, origposar, origsizear;
+	unpackColumn( idar, size, si, se, false);
+	unpackColumn( ordposar, size, si, se, deltaEncoding);
+	unpackColumn( origsegar, size, si, se, deltaEncoding);
+	unpackColumn( origposar, size, si, se, deltaEncoding);
+	unpackColumn( origsizear, size, si, se, false);
+	if (si != se)
+	{
+		throw strus::runtime_error(_TXT("corrupt lexem batch image: %s"), _TXT("unexpected data at end"));
+	}
+	dest.reserve( dest.size() + size);
+	std::size_t ii = 0;
+	for (; ii < size; ++ii)
+	{
+		dest.push_back( idar[ ii], ordposar[ ii], origsegar[ ii], origposar[ ii], origsizear[ ii]);
+	}
+}
+
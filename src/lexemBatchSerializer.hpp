@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2017 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Binary serialization of columnar lexem batches
+/// \file "lexemBatchSerializer.hpp"
+#ifndef _STRUS_PATTERN_LEXEM_BATCH_SERIALIZER_HPP_INCLUDED
+#define _STRUS_PATTERN_LEXEM_BATCH_SERIALIZER_HPP_INCLUDED
+#include "strus/patternLexemBatch.hpp"
+#include <string>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Append the binary image of a lexem batch to a string
+/// \param[out] dest where to append the image to
+/// \param[in] batch batch to serialize
+/// \param[in] deltaEncoding true, if the positions should be stored as differences to their predecessor, resulting in a smaller image for lexems in ascending order
+void serializeLexemBatch( std::string& dest, const PatternLexemBatch& batch, bool deltaEncoding);
+
+/// \brief Build a lexem batch from its binary image
+/// \param[out] dest where to append the deserialized lexems to
+/// \param[in] src pointer to the image
+/// \param[in] srcsize size of the image in bytes
+/// \remark throws on a corrupt image
+void deserializeLexemBatch( PatternLexemBatch& dest, const char* src, std::size_t srcsize);
+
+}//namespace
+#endif
+
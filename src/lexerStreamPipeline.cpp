@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2017 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Pipeline reading a text in chunks in one thread while matching the chunks read before in another
+/// \file "lexerStreamPipeline.cpp"
+#include "lexerStreamPipeline.hpp"
+#include "patternLexer.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "internationalization.hpp"
+#include "utils.hpp"
+#include <string>
+#include <new>
+#include <stdexcept>
+
+using namespace strus;
+
+enum {NofChunkBuffers=4, ChunkBufferSize=(1<<16)};
+
+/// \brief Bounded ring of buffers passing the chunks of a text from the reader thread to the matching thread
+class ChunkRing
+{
+public:
+	explicit ChunkRing( std::size_t nofBuffers_, std::size_t bufferSize_)
+		:m_mutex(),m_notEmpty(),m_notFull(),m_bufar(nofBuffers_,std::string(bufferSize_,'\0')),m_sizear(nofBuffers_,0),m_bufferSize(bufferSize_),m_readidx(0),m_fill(0),m_eof(false),m_terminated(false),m_error(){}
+
+	std::size_t bufferSize() const
+	{
+		return m_bufferSize;
+	}
+
+	/// \brief Get the next free buffer to read a chunk into, waits until one is released
+	/// \return the buffer or 0 if the matching thread terminated
+	char* waitWriteBuffer()
+	{
+		utils::ScopedLock lock( m_mutex);
+		while (m_fill == m_bufar.size() && !m_terminated)
+		{
+			m_notFull.wait( lock);
+		}
+		if (m_terminated) return 0;
+		return &m_bufar[ (m_readidx + m_fill) % m_bufar.size()][0];
+	}
+
+	/// \brief Pass the buffer got with waitWriteBuffer to the matching thread
+	/// \param[in] size number of bytes read into the buffer, 0 for the end of the text
+	void pushBuffer( std::size_t size)
+	{
+		utils::ScopedLock lock( m_mutex);
+		if (size)
+		{
+			m_sizear[ (m_readidx + m_fill) % m_bufar.size()] = size;
+			++m_fill;
+		}
+		else
+		{
+			m_eof = true;
+		}
+		m_notEmpty.notify_one();
+	}
+
+	/// \brief Terminate the text with an error of the reader
+	void pushError( const char* msg)
+	{
+		utils::ScopedLock lock( m_mutex);
+		m_error = msg;
+		m_eof = true;
+		m_notEmpty.notify_one();
+	}
+
+	/// \brief Get the next chunk to match, waits until one is read
+	/// \return false at the end of the text
+	bool waitReadBuffer( const char*& chunk, std::size_t& chunksize)
+	{
+		utils::ScopedLock lock( m_mutex);
+		while (m_fill == 0 && !m_eof)
+		{
+			m_notEmpty.wait( lock);
+		}
+		if (m_fill == 0) return false;
+		chunk = m_bufar[ m_readidx].c_str();
+		chunksize = m_sizear[ m_readidx];
+		return true;
+	}
+
+	/// \brief Release the buffer got with waitReadBuffer for the reader thread
+	void popBuffer()
+	{
+		utils::ScopedLock lock( m_mutex);
+		m_readidx = (m_readidx + 1) % m_bufar.size();
+		--m_fill;
+		m_notFull.notify_one();
+	}
+
+	/// \brief Stop the reader thread, called when the matching thread does not consume any chunks anymore
+	void terminate()
+	{
+		utils::ScopedLock lock( m_mutex);
+		m_terminated = true;
+		m_notFull.notify_one();
+	}
+
+	/// \brief Get the error of the reader, empty if there was none
+	std::string error()
+	{
+		utils::ScopedLock lock( m_mutex);
+		return m_error;
+	}
+
+private:
+	ChunkRing( const ChunkRing&){}		//... non copyable
+	void operator=( const ChunkRing&){}	//... non copyable
+
+private:
+	utils::Mutex m_mutex;
+	utils::Condition m_notEmpty;
+	utils::Condition m_notFull;
+	std::vector<std::string> m_bufar;
+	std::vector<std::size_t> m_sizear;
+	std::size_t m_bufferSize;
+	std::size_t m_readidx;
+	std::size_t m_fill;
+	bool m_eof;
+	bool m_terminated;
+	std::string m_error;
+};
+
+/// \brief Terminates a chunk ring and joins the reader thread when leaving the scope, also when leaving with an exception
+class ChunkReaderThreadGuard
+{
+public:
+	ChunkReaderThreadGuard( ChunkRing* ring_, utils::ThreadGroup* threads_)
+		:m_ring(ring_),m_threads(threads_){}
+	~ChunkReaderThreadGuard()
+	{
+		m_ring->terminate();
+		try
+		{
+			m_threads->join_all();
+		}
+		catch (...){}
+	}
+
+private:
+	ChunkReaderThreadGuard( const ChunkReaderThreadGuard&){}	//... non copyable
+	void operator=( const ChunkReaderThreadGuard&){}		//... non copyable
+
+private:
+	ChunkRing* m_ring;
+	utils::ThreadGroup* m_threads;
+};
+
+/// \brief Thread reading the chunks of a text into a chunk ring
+class ChunkReaderWorker
+{
+public:
+	ChunkReaderWorker( ChunkRing* ring_, PatternLexerChunkReader readChunk_, void* reader_)
+		:m_ring(ring_),m_readChunk(readChunk_),m_reader(reader_){}
+
+	void run()
+	{
+		try
+		{
+			for (;;)
+			{
+				char* buf = m_ring->waitWriteBuffer();
+				if (!buf) break;
+
+				std::size_t readsize = 0;
+				if (!m_readChunk( m_reader, buf, m_ring->bufferSize(), readsize))
+				{
+					m_ring->pushError( _TXT("reader callback failed"));
+					break;
+				}
+				if (readsize > m_ring->bufferSize())
+				{
+					m_ring->pushError( _TXT("reader callback returned more bytes than the size of the buffer"));
+					break;
+				}
+				m_ring->pushBuffer( readsize);
+				if (!readsize) break;
+			}
+		}
+		catch (const std::bad_alloc&)
+		{
+			m_ring->pushError( _TXT("out of memory"));
+		}
+		catch (const std::exception& err)
+		{
+			m_ring->pushError( err.what());
+		}
+		catch (...)
+		{
+			m_ring->pushError( _TXT("uncaught exception"));
+		}
+	}
+
+	struct Runner
+	{
+		explicit Runner( ChunkReaderWorker* worker_)
+			:m_worker(worker_){}
+		Runner( const Runner& o)
+			:m_worker(o.m_worker){}
+
+		void operator()()
+		{
+			m_worker->run();
+		}
+
+		ChunkReaderWorker* m_worker;
+	};
+
+private:
+	ChunkRing* m_ring;
+	PatternLexerChunkReader m_readChunk;
+	void* m_reader;
+};
+
+void strus::matchLexerStreamPipeline(
+		std::vector<analyzer::PatternLexem>& res,
+		PatternLexerContextStreamInterface* ctx,
+		PatternLexerChunkReader readChunk,
+		void* reader,
+		ErrorBufferInterface* errorhnd)
+{
+	ctx->open();
+	if (errorhnd->hasError()) return;
+
+	ChunkRing ring( NofChunkBuffers, ChunkBufferSize);
+	ChunkReaderWorker worker( &ring, readChunk, reader);
+	{
+		utils::ThreadGroup threads;
+		ChunkReaderThreadGuard guard( &ring, &threads);
+		threads.create_thread( ChunkReaderWorker::Runner( &worker));
+
+		const char* chunk;
+		std::size_t chunksize;
+		while (ring.waitReadBuffer( chunk, chunksize))
+		{
+			ctx->feed( res, chunk, chunksize);
+			ring.popBuffer();
+			if (errorhnd->hasError()) return;
+		}
+	}
+	std::string readerError = ring.error();
+	if (!readerError.empty())
+	{
+		throw strus::runtime_error( _TXT("error reading the text to match: %s"), readerError.c_str());
+	}
+	ctx->close( res);
+}
+
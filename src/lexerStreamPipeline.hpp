@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2017 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Pipeline reading a text in chunks in one thread while matching the chunks read before in another
+/// \file "lexerStreamPipeline.hpp"
+#ifndef _STRUS_PATTERN_LEXER_STREAM_PIPELINE_HPP_INCLUDED
+#define _STRUS_PATTERN_LEXER_STREAM_PIPELINE_HPP_INCLUDED
+#include "strus/lib/pattern.hpp"
+#include "strus/analyzer/patternLexem.hpp"
+#include <vector>
+
+namespace strus {
+
+/// \brief Forward declaration
+class PatternLexerContextStreamInterface;
+/// \brief Forward declaration
+class ErrorBufferInterface;
+
+/// \brief Match a text read with a reader callback, the chunks are read by a separate thread into a bounded ring of buffers while the calling thread matches the chunks read before
+/// \param[out] res where to append the lexems matched to
+/// \param[in] ctx lexer context used for matching
+/// \param[in] readChunk callback reading the next chunk of the text
+/// \param[in] reader object passed to the callback
+/// \param[in] errorhnd error buffer interface of the lexer context, checked after every call of the context
+/// \remark throws if the reader fails
+void matchLexerStreamPipeline(
+		std::vector<analyzer::PatternLexem>& res,
+		PatternLexerContextStreamInterface* ctx,
+		PatternLexerChunkReader readChunk,
+		void* reader,
+		ErrorBufferInterface* errorhnd);
+
+}//namespace
+#endif
+
@@ -9,8 +9,15 @@
 /// \file libstrus_stream.cpp
 #include "strus/lib/pattern.hpp"
 #include "strus/errorBufferInterface.hpp"
+#include "strus/patternLexerContextInterface.hpp"
+#include "strus/patternLexerInstanceInterface.hpp"
+#include "strus/patternMatcherInstanceInterface.hpp"
+#include "strus/patternMatcherContextInterface.hpp"
+#include "strus/patternLexemBatch.hpp"
+#include "lexemBatchSerializer.hpp"
 #include "patternMatcher.hpp"
 #include "patternLexer.hpp"
+#include "lexerStreamPipeline.hpp"
 #include "strus/base/dll_tags.hpp"
 #include "internationalization.hpp"
 #include "errorUtils.hpp"
@@ -46,3 +53,322 @@ DLL_PUBLIC PatternLexerInterface* strus::createPatternLexer_stream( ErrorBufferI
 	CATCH_ERROR_MAP_RETURN( _TXT("error creating char regex match interface: %s"), *errorhnd, 0);
 }
 
+DLL_PUBLIC bool strus::definePatternLexemCombination( PatternLexerInstanceInterface* lexer, unsigned int id, const std::string& expression, unsigned int span, unsigned int level, analyzer::PositionBind posbind, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternLexerInstanceCombinationInterface* combinationlexer = dynamic_cast<PatternLexerInstanceCombinationInterface*>( lexer);
+		if (!combinationlexer)
+		{
+			throw strus::runtime_error(_TXT("lexer does not support logical combinations of lexems"));
+		}
+		combinationlexer->defineLexemCombination( id, expression, span, level, posbind);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error defining lexem combination: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::getPatternMatcherReferencedTerms( std::vector<unsigned int>& dest, const PatternMatcherInstanceInterface* matcher, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		const PatternMatcherInstanceTermsInterface* termsmatcher = dynamic_cast<const PatternMatcherInstanceTermsInterface*>( matcher);
+		if (!termsmatcher)
+		{
+			throw strus::runtime_error(_TXT("pattern matcher does not support inspecting the terms referenced"));
+		}
+		dest = termsmatcher->getReferencedTerms();
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error getting the terms referenced by a pattern matcher: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::definePatternLexerReferencedLexems( PatternLexerInstanceInterface* lexer, const std::vector<unsigned int>& ids, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternLexerInstanceVocabularyInterface* reflexer = dynamic_cast<PatternLexerInstanceVocabularyInterface*>( lexer);
+		if (!reflexer)
+		{
+			throw strus::runtime_error(_TXT("lexer does not support leaving out lexems not referenced"));
+		}
+		reflexer->defineReferencedLexems( ids);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error defining the lexems referenced: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::getPatternLexerVocabulary( std::vector<unsigned int>& dest, const PatternLexerInstanceInterface* lexer, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		const PatternLexerInstanceVocabularyInterface* voclexer = dynamic_cast<const PatternLexerInstanceVocabularyInterface*>( lexer);
+		if (!voclexer)
+		{
+			throw strus::runtime_error(_TXT("lexer does not support inspecting the lexems defined"));
+		}
+		dest = voclexer->getVocabulary();
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error getting the vocabulary of a lexer: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::definePatternMatcherTermVocabulary( PatternMatcherInstanceInterface* matcher, const std::vector<unsigned int>& termids, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternMatcherInstanceTermsInterface* termsmatcher = dynamic_cast<PatternMatcherInstanceTermsInterface*>( matcher);
+		if (!termsmatcher)
+		{
+			throw strus::runtime_error(_TXT("pattern matcher does not support defining the term vocabulary"));
+		}
+		termsmatcher->defineTermVocabulary( termids);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error defining the term vocabulary of a pattern matcher: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::getPatternMatcherImage( std::string& dest, const PatternMatcherInstanceInterface* matcher, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		const PatternMatcherInstanceImageInterface* imgmatcher = dynamic_cast<const PatternMatcherInstanceImageInterface*>( matcher);
+		if (!imgmatcher)
+		{
+			throw strus::runtime_error(_TXT("pattern matcher does not support binary images"));
+		}
+		dest = imgmatcher->getImage();
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error getting the binary image of a pattern matcher: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::loadPatternMatcherImage( PatternMatcherInstanceInterface* matcher, const char* image, std::size_t imagesize, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternMatcherInstanceImageInterface* imgmatcher = dynamic_cast<PatternMatcherInstanceImageInterface*>( matcher);
+		if (!imgmatcher)
+		{
+			throw strus::runtime_error(_TXT("pattern matcher does not support binary images"));
+		}
+		imgmatcher->loadImage( image, imagesize);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error loading a pattern matcher from a binary image: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::loadPatternMatcherImageFile( PatternMatcherInstanceInterface* matcher, const std::string& path, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternMatcherInstanceImageInterface* imgmatcher = dynamic_cast<PatternMatcherInstanceImageInterface*>( matcher);
+		if (!imgmatcher)
+		{
+			throw strus::runtime_error(_TXT("pattern matcher does not support binary images"));
+		}
+		imgmatcher->loadImageFile( path);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error loading a pattern matcher from a binary image file: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::setPatternLexerContextLexemMask( PatternLexerContextInterface* ctx, const std::vector<unsigned int>& enabledIds, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternLexerContextLexemMaskInterface* maskctx = dynamic_cast<PatternLexerContextLexemMaskInterface*>( ctx);
+		if (!maskctx)
+		{
+			throw strus::runtime_error(_TXT("lexer context does not support restricting the lexems reported"));
+		}
+		maskctx->setLexemMask( enabledIds);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error setting the lexems enabled in a lexer context: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::clearPatternLexerContextLexemMask( PatternLexerContextInterface* ctx, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternLexerContextLexemMaskInterface* maskctx = dynamic_cast<PatternLexerContextLexemMaskInterface*>( ctx);
+		if (!maskctx)
+		{
+			throw strus::runtime_error(_TXT("lexer context does not support restricting the lexems reported"));
+		}
+		maskctx->clearLexemMask();
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error resetting the lexems enabled in a lexer context: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::matchPatternLexemBatch( PatternLexemBatch& dest, PatternLexerContextInterface* ctx, const char* src, std::size_t srclen, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternLexerContextBatchInterface* batchctx = dynamic_cast<PatternLexerContextBatchInterface*>( ctx);
+		if (batchctx)
+		{
+			batchctx->matchBatch( dest, src, srclen);
+		}
+		else
+		{
+			std::vector<analyzer::PatternLexem> lexems = ctx->match( src, srclen);
+			dest.clear();
+			dest.reserve( lexems.size());
+			std::vector<analyzer::PatternLexem>::const_iterator li = lexems.begin(), le = lexems.end();
+			for (; li != le; ++li)
+			{
+				dest.push_back( *li);
+			}
+		}
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error matching lexems into a batch: %s"), *errorhnd, false);
+}
+
+static PatternLexerContextStreamInterface* getPatternLexerContextStream( PatternLexerContextInterface* ctx)
+{
+	PatternLexerContextStreamInterface* streamctx = dynamic_cast<PatternLexerContextStreamInterface*>( ctx);
+	if (!streamctx)
+	{
+		throw strus::runtime_error(_TXT("lexer context does not support matching a text fed in chunks"));
+	}
+	return streamctx;
+}
+
+DLL_PUBLIC bool strus::openPatternLexerStream( PatternLexerContextInterface* ctx, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		getPatternLexerContextStream( ctx)->open();
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error opening a text fed in chunks to a lexer: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::feedPatternLexerStream( std::vector<analyzer::PatternLexem>& dest, PatternLexerContextInterface* ctx, const char* chunk, std::size_t chunksize, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		getPatternLexerContextStream( ctx)->feed( dest, chunk, chunksize);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error feeding a chunk of a text to a lexer: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::closePatternLexerStream( std::vector<analyzer::PatternLexem>& dest, PatternLexerContextInterface* ctx, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		getPatternLexerContextStream( ctx)->close( dest);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error closing a text fed in chunks to a lexer: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::matchPatternLexerStream( std::vector<analyzer::PatternLexem>& dest, PatternLexerContextInterface* ctx, PatternLexerChunkReader readChunk, void* reader, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		matchLexerStreamPipeline( dest, getPatternLexerContextStream( ctx), readChunk, reader, errorhnd);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error matching lexems in a text read in chunks: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::putInputPatternLexemBatch( PatternMatcherContextInterface* ctx, const PatternLexemBatch& batch, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternMatcherContextBatchInterface* batchctx = dynamic_cast<PatternMatcherContextBatchInterface*>( ctx);
+		if (batchctx)
+		{
+			batchctx->putInputBatch( batch);
+		}
+		else
+		{
+			std::size_t bi = 0, be = batch.size();
+			for (; bi != be; ++bi)
+			{
+				ctx->putInput( batch[ bi]);
+			}
+		}
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error feeding lexem batch to pattern matcher: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::putInputPatternLexems( PatternMatcherContextInterface* ctx, const analyzer::PatternLexem* ar, std::size_t size, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		PatternMatcherContextBatchInterface* batchctx = dynamic_cast<PatternMatcherContextBatchInterface*>( ctx);
+		if (batchctx)
+		{
+			batchctx->putInputArray( ar, size);
+		}
+		else
+		{
+			std::size_t ai = 0;
+			for (; ai != size; ++ai)
+			{
+				ctx->putInput( ar[ ai]);
+			}
+		}
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error feeding lexem array to pattern matcher: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::matchPatternMatcherDocuments( std::vector<std::vector<analyzer::PatternMatcherResult> >& results, const PatternMatcherInstanceInterface* matcher, const std::vector<PatternLexemBatch>& documents, unsigned int nofThreads, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		const PatternMatcherInstanceBatchInterface* batchmatcher = dynamic_cast<const PatternMatcherInstanceBatchInterface*>( matcher);
+		if (!batchmatcher)
+		{
+			throw strus::runtime_error(_TXT("pattern matcher does not support matching document batches"));
+		}
+		batchmatcher->matchDocuments( results, documents, nofThreads);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error matching a batch of documents: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::matchPatternMatcherDocumentParallel( std::vector<analyzer::PatternMatcherResult>& results, const PatternMatcherInstanceInterface* matcher, const PatternLexemBatch& document, unsigned int nofThreads, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		const PatternMatcherInstanceBatchInterface* batchmatcher = dynamic_cast<const PatternMatcherInstanceBatchInterface*>( matcher);
+		if (!batchmatcher)
+		{
+			throw strus::runtime_error(_TXT("pattern matcher does not support matching documents in parallel"));
+		}
+		batchmatcher->matchDocumentParallel( results, document, nofThreads);
+		return !errorhnd->hasError();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error matching a document in parallel: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::serializePatternLexemBatch( std::string& dest, const PatternLexemBatch& batch, bool deltaEncoding, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		serializeLexemBatch( dest, batch, deltaEncoding);
+		return true;
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error serializing lexem batch: %s"), *errorhnd, false);
+}
+
+DLL_PUBLIC bool strus::deserializePatternLexemBatch( PatternLexemBatch& dest, const char* src, std::size_t srcsize, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		deserializeLexemBatch( dest, src, srcsize);
+		return true;
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error deserializing lexem batch: %s"), *errorhnd, false);
+}
+
@@ -13,6 +13,7 @@
 #include "strus/analyzer/positionBind.hpp"
 #include "strus/patternLexerInstanceInterface.hpp"
 #include "strus/patternLexerContextInterface.hpp"
+#include "strus/patternLexemBatch.hpp"
 #include "strus/errorBufferInterface.hpp"
 #include "strus/reference.hpp"
 #include "strus/base/stdint.h"
@@ -25,9 +26,13 @@
 #include "hs.h"
 #include <vector>
 #include <string>
+#include <set>
+#include <map>
 #include <cstring>
+#include <cstdlib>
 #include <stdexcept>
 #include <limits>
+#include <algorithm>
 #include <iostream>
 #undef TRE_USE_SYSTEM_REGEX_H
 #include <tre/tre.h>
@@ -40,37 +45,32 @@ using namespace strus::analyzer;
 typedef unsigned long long unsigned_long_long;
 
 enum {MaxPatternId=(1 << 30)-1};
+//... the match of a combination must stay below the maximum size of a lexem match, also after mapping the positions in a source mapped to lower case back to the original source
+enum {MaxCombinationSpan=(1 << 14)};
 
+/// \brief Attributes of a lexem needed at match time
 struct PatternDef
 {
 public:
 	PatternDef()
-		:m_expression()
-		,m_expression_onebyte()
-		,m_subexpref(0)
+		:m_subexpref(0)
 		,m_id(0)
 		,m_posbind(analyzer::BindContent)
 		,m_level(0)
-		,m_editdist(0)
-		,m_symtabref(0){}
+		,m_symtabref(0)
+		,m_fixwidth(0){}
 	PatternDef(
-			const std::string& expression_,
 			unsigned int subexpref_,
 			unsigned int id_,
 			analyzer::PositionBind posbind_,
 			unsigned int level_,
-			unsigned int resultidx_,
-			unsigned int editdist_,
 			unsigned int symtabref_=0)
-		:m_expression(expression_)
-		,m_expression_onebyte()
-		,m_subexpref(subexpref_)
+		:m_subexpref(subexpref_)
 		,m_id(id_)
 		,m_posbind(posbind_)
 		,m_level(level_)
-		,m_resultidx(resultidx_)
-		,m_editdist(editdist_)
 		,m_symtabref((uint8_t)symtabref_)
+		,m_fixwidth(0)
 	{
 		if (subexpref_ >= std::numeric_limits<uint32_t>::max())
 		{
@@ -84,29 +84,18 @@ public:
 		{
 			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "level", (unsigned int)std::numeric_limits<uint8_t>::max());
 		}
-		if (resultidx_ > std::numeric_limits<uint8_t>::max())
-		{
-			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "result index", (unsigned int)std::numeric_limits<uint8_t>::max());
-		}
-		if (editdist_ > std::numeric_limits<uint8_t>::max())
-		{
-			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "edit distance", (unsigned int)std::numeric_limits<uint8_t>::max());
-		}
 		if (symtabref_ > std::numeric_limits<uint8_t>::max())
 		{
 			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "symbol table reference", (unsigned int)std::numeric_limits<uint8_t>::max());
 		}
 	}
 	PatternDef( const PatternDef& o)
-		:m_expression(o.m_expression)
-		,m_expression_onebyte(o.m_expression_onebyte)
-		,m_subexpref(o.m_subexpref)
+		:m_subexpref(o.m_subexpref)
 		,m_id(o.m_id)
 		,m_posbind(o.m_posbind)
 		,m_level(o.m_level)
-		,m_resultidx(o.m_resultidx)
-		,m_editdist(o.m_editdist)
-		,m_symtabref(o.m_symtabref){}
+		,m_symtabref(o.m_symtabref)
+		,m_fixwidth(o.m_fixwidth){}
 
 	unsigned int subexpref() const
 	{
@@ -124,25 +113,13 @@ public:
 	{
 		return m_level;
 	}
-	unsigned int resultidx() const
-	{
-		return m_resultidx;
-	}
-	unsigned int editdist() const
-	{
-		return m_editdist;
-	}
 	unsigned int symtabref() const
 	{
 		return m_symtabref;
 	}
-	const std::string& expression() const
-	{
-		return m_expression;
-	}
-	const std::string& expression_onebyte() const
+	unsigned int fixwidth() const
 	{
-		return m_expression_onebyte;
+		return m_fixwidth;
 	}
 	void setSymtabref( unsigned int symtabref_)
 	{
@@ -152,27 +129,114 @@ public:
 		}
 		m_symtabref = symtabref_;
 	}
-	void setExpressionOneByteCharMap()
-	{
-		OneByteCharMap obcmap;
-		obcmap.init( m_expression.c_str(), m_expression.size());
-		m_expression_onebyte = obcmap.value;
-	}
 	void setSubExpressionRef( unsigned int subexpref_)
 	{
 		m_subexpref = subexpref_;
 	}
+	void setFixWidth( unsigned int fixwidth_)
+	{
+		if (fixwidth_ > std::numeric_limits<uint8_t>::max())
+		{
+			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "fixed match width", (unsigned int)std::numeric_limits<uint8_t>::max());
+		}
+		m_fixwidth = fixwidth_;
+	}
 
 private:
-	std::string m_expression;		///< regular expression string
-	std::string m_expression_onebyte;	///< regular expression string mapped down to one byte character set for prematching
 	uint32_t m_subexpref;			///< index of sub expression in sub expression table, for 2nd matching to get the sub expression match
 	uint32_t m_id;				///< id of the lexem as defined by definedLexem
 	uint8_t m_posbind;			///< analyzer position bind specificaction
 	uint8_t m_level;			///< priority level (bigger => higher priority)
-	uint8_t m_resultidx;			///< index of subexpression result selected, 0 for the whole match
-	uint8_t m_editdist;			///< edit distance (Levenstein) for matching patterns
 	uint8_t m_symtabref;			///< symbol table to use
+	uint8_t m_fixwidth;			///< size of every match in bytes of the scanned text if fixed, for calculating the start of match without hyperscan SOM, 0 if SOM is needed
+};
+
+/// \brief Attributes of a lexem only needed for building the automaton, released after compile
+struct PatternSource
+{
+public:
+	PatternSource()
+		:m_exprpos(0)
+		,m_exprsize(0)
+		,m_resultidx(0)
+		,m_editdist(0)
+		,m_hamming(false)
+		,m_combinationSpan(0){}
+	PatternSource(
+			std::size_t exprpos_,
+			std::size_t exprsize_,
+			unsigned int resultidx_,
+			unsigned int editdist_,
+			bool hamming_,
+			unsigned int combinationSpan_=0)
+		:m_exprpos(exprpos_)
+		,m_exprsize(exprsize_)
+		,m_resultidx(resultidx_)
+		,m_editdist(editdist_)
+		,m_hamming(hamming_)
+		,m_combinationSpan(combinationSpan_)
+	{
+		if (exprpos_ >= std::numeric_limits<uint32_t>::max() || exprsize_ >= std::numeric_limits<uint32_t>::max())
+		{
+			throw strus::runtime_error(_TXT("too many patterns defined, size of expression string pool out of range"));
+		}
+		if (resultidx_ > std::numeric_limits<uint8_t>::max())
+		{
+			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "result index", (unsigned int)std::numeric_limits<uint8_t>::max());
+		}
+		if (editdist_ > std::numeric_limits<uint8_t>::max())
+		{
+			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "edit distance", (unsigned int)std::numeric_limits<uint8_t>::max());
+		}
+		if (combinationSpan_ > MaxCombinationSpan)
+		{
+			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "span of lexem combination", (unsigned int)MaxCombinationSpan);
+		}
+	}
+	PatternSource( const PatternSource& o)
+		:m_exprpos(o.m_exprpos)
+		,m_exprsize(o.m_exprsize)
+		,m_resultidx(o.m_resultidx)
+		,m_editdist(o.m_editdist)
+		,m_hamming(o.m_hamming)
+		,m_combinationSpan(o.m_combinationSpan){}
+
+	std::size_t exprpos() const
+	{
+		return m_exprpos;
+	}
+	std::size_t exprsize() const
+	{
+		return m_exprsize;
+	}
+	unsigned int resultidx() const
+	{
+		return m_resultidx;
+	}
+	unsigned int editdist() const
+	{
+		return m_editdist;
+	}
+	bool hamming() const
+	{
+		return m_hamming;
+	}
+	bool combination() const
+	{
+		return m_combinationSpan != 0;
+	}
+	unsigned int combinationSpan() const
+	{
+		return m_combinationSpan;
+	}
+
+private:
+	uint32_t m_exprpos;			///< start of the regular expression string in the expression string pool
+	uint32_t m_exprsize;			///< size of the regular expression string in bytes
+	uint8_t m_resultidx;			///< index of subexpression result selected, 0 for the whole match
+	uint8_t m_editdist;			///< edit distance (Levenstein) or Hamming distance for matching patterns
+	bool m_hamming;				///< true if m_editdist is a Hamming distance (only substitutions allowed)
+	uint16_t m_combinationSpan;		///< maximum span in bytes of the operand matches if the expression is a logical combination of lexem identifiers and not a regular expression, 0 else
 };
 
 class HsPatternTable
@@ -183,9 +247,10 @@ public:
 	unsigned int* idar;
 	unsigned int* flagar;
 	hs_expr_ext_t** extar;
+	std::string exprpool;		///< string pool for expressions transformed for hyperscan, referenced by patternar
 
 	HsPatternTable()
-		:arsize(0),patternar(0),idar(0),flagar(0),extar(0)
+		:arsize(0),patternar(0),idar(0),flagar(0),extar(0),exprpool()
 	{}
 
 	void init( std::size_t arsize_)
@@ -226,12 +291,1006 @@ public:
 	}
 };
 
+static inline bool isWordChar( unsigned char ch)
+{
+	return ((ch|32) >= 'a' && (ch|32) <= 'z') || (ch >= '0' && ch <= '9') || ch == '_';
+}
+
+///\brief Evaluate if there is a word boundary (as defined for '\b' without UCP) at a position in a string
+static inline bool isWordBoundary( const unsigned char* src, std::size_t srclen, std::size_t pos)
+{
+	bool prev = pos > 0 && isWordChar( src[ pos-1]);
+	bool next = pos < srclen && isWordChar( src[ pos]);
+	return prev != next;
+}
+
+///\brief Try to interpret a regular expression as plain string literal with optional word boundary assertions at start and end
+///\param[out] literal the string matched by the expression
+///\param[out] wordBoundStart true, if the expression starts with '\b'
+///\param[out] wordBoundEnd true, if the expression ends with '\b'
+///\return true, if the expression is a plain string literal
+static bool parseLiteralExpression( std::string& literal, bool& wordBoundStart, bool& wordBoundEnd, const std::string& expression)
+{
+	char const* si = expression.c_str();
+	char const* se = si + expression.size();
+	literal.clear();
+	wordBoundStart = false;
+	wordBoundEnd = false;
+
+	if (se - si >= 2 && si[0] == '\\' && si[1] == 'b')
+	{
+		wordBoundStart = true;
+		si += 2;
+	}
+	for (; si != se; ++si)
+	{
+		if (*si == '\\')
+		{
+			++si;
+			if (si == se) return false;
+			if (*si == 'b' && si+1 == se && !literal.empty())
+			{
+				wordBoundEnd = true;
+				break;
+			}
+			if (((*si|32) >= 'a' && (*si|32) <= 'z') || (*si >= '0' && *si <= '9'))
+			{
+				//... escape sequence with a special meaning (character class, back reference, etc.)
+				return false;
+			}
+			literal.push_back( *si);
+		}
+		else if (std::strchr( "^$.|?*+()[]{}", *si))
+		{
+			//... operator (also the '\0', as it matches the string terminator)
+			return false;
+		}
+		else
+		{
+			literal.push_back( *si);
+		}
+	}
+	return !literal.empty();
+}
+
+/// \brief Test if a character is an ASCII letter or digit
+static bool isAsciiAlnum( char ch)
+{
+	return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+}
+
+/// \brief Test if a character is a hexadecimal digit and get its value
+static bool parseHexDigit( unsigned int& val, char ch)
+{
+	if (ch >= '0' && ch <= '9') {val = ch - '0'; return true;}
+	if (ch >= 'a' && ch <= 'f') {val = ch - 'a' + 10; return true;}
+	if (ch >= 'A' && ch <= 'F') {val = ch - 'A' + 10; return true;}
+	return false;
+}
+
+/// \brief Test if the name of a unicode property or of a POSIX character class (with an optional leading '^' for negation) refers to a class that depends on case
+static bool isCaseDependentClassName( const std::string& name)
+{
+	std::string nm( (!name.empty() && name[0] == '^') ? name.substr( 1) : name);
+	return nm == "Lu" || nm == "Ll" || nm == "Lt" || nm == "L&" || nm == "Lc"
+		|| nm == "upper" || nm == "lower";
+}
+
+/// \brief Parse an escape sequence of a regular expression
+/// \param[out] chr the character denoted by the escape sequence, if it denotes a single character
+/// \param[in,out] ei pointer to the backslash starting the escape sequence, moved to the end of the escape sequence
+/// \param[in] ee end of the expression
+/// \return true, if the escape sequence denotes a single character (e.g. '\x{C4}' or '\.'), false, if it has a special meaning (e.g. '\w', '\b' or '\p{L}')
+static bool parseEscapeSequence( unsigned int& chr, char const*& ei, const char* ee, const std::string& expr)
+{
+	++ei;
+	if (ei == ee)
+	{
+		return false;
+	}
+	if (!isAsciiAlnum( *ei))
+	{
+		//... escaped character without special meaning
+		std::size_t chrsize;
+		chr = utf8decode( ei, ee - ei, chrsize);
+		if (!chrsize) chrsize = 1;
+		ei += chrsize;
+		return chr != 0;
+	}
+	char op = *ei++;
+	unsigned int digit;
+	switch (op)
+	{
+		case 'x':
+			chr = 0;
+			if (ei < ee && *ei == '{')
+			{
+				for (++ei; ei < ee && parseHexDigit( digit, *ei); ++ei) chr = chr * 16 + digit;
+				if (ei < ee && *ei == '}') ++ei;
+			}
+			else
+			{
+				for (int di=0; di < 2 && ei < ee && parseHexDigit( digit, *ei); ++di,++ei) chr = chr * 16 + digit;
+			}
+			return true;
+		case 'o':
+			chr = 0;
+			if (ei < ee && *ei == '{')
+			{
+				for (++ei; ei < ee && *ei >= '0' && *ei <= '7'; ++ei) chr = chr * 8 + (*ei - '0');
+				if (ei < ee && *ei == '}') ++ei;
+			}
+			return true;
+		case '0':
+			chr = 0;
+			for (int di=0; di < 2 && ei < ee && *ei >= '0' && *ei <= '7'; ++di,++ei) chr = chr * 8 + (*ei - '0');
+			return true;
+		case 'c':
+			chr = 0;
+			if (ei < ee) chr = (unsigned char)*ei++ ^ 0x40;
+			return true;
+		case 'a': chr = 7; return true;
+		case 'e': chr = 27; return true;
+		case 'f': chr = 12; return true;
+		case 'n': chr = 10; return true;
+		case 'r': chr = 13; return true;
+		case 't': chr = 9; return true;
+		case 'p':
+		case 'P':
+		{
+			std::string name;
+			if (ei < ee && *ei == '{')
+			{
+				for (++ei; ei < ee && *ei != '}'; ++ei) name.push_back( *ei);
+				if (ei < ee) ++ei;
+			}
+			else if (ei < ee)
+			{
+				name.push_back( *ei++);
+			}
+			if (isCaseDependentClassName( name))
+			{
+				throw strus::runtime_error(_TXT("option CASEFOLD is not applicable to the expression '%s' with a character class depending on case"), expr.c_str());
+			}
+			return false;
+		}
+		default:
+			//... escape sequence with a special meaning, the letters or digits of the sequence are left as they are
+			if (ei < ee && (*ei == '{' || *ei == '<'))
+			{
+				char eb = (*ei == '{') ? '}' : '>';
+				for (++ei; ei < ee && *ei != eb; ++ei){}
+				if (ei < ee) ++ei;
+			}
+			return false;
+	}
+}
+
+/// \brief Test if the automaton built from a regular expression depends on the Unicode flags, i.e. if it contains a construct matching characters differently with HS_FLAG_UTF8 or HS_FLAG_UCP set
+/// \param[in] expr the expression as passed to hyperscan
+/// \param[in] flags the hyperscan flags of the expression
+/// \remark Constructs matching any character or the complement of a class (e.g. '.', '[^a]' or '\W') match multibyte characters with HS_FLAG_UTF8, ASCII classes (e.g. '\w' or '[[:alpha:]]') and caseless matching are extended with HS_FLAG_UCP
+/// \note The test is conservative, escape sequences not denoting a single ASCII character are considered as Unicode sensitive
+static bool isUnicodeSensitiveExpression( const char* expr, unsigned int flags)
+{
+	bool ucp = (flags & HS_FLAG_UCP) != 0;
+	if (ucp && (flags & HS_FLAG_CASELESS)) return true;
+
+	char const* ei = expr;
+	const char* ee = expr + std::strlen( expr);
+	bool inclass = false;
+	while (ei < ee)
+	{
+		if ((unsigned char)*ei >= 0x80) return true;
+		switch (*ei)
+		{
+			case '\\':
+			{
+				if (ei+1 < ee)
+				{
+					char op = ei[1];
+					if (op == 'w' || op == 'd' || op == 's' || op == 'b' || op == 'h' || op == 'v')
+					{
+						if (ucp) return true;
+						ei += 2;
+						continue;
+					}
+					if (op == 'p' || op == 'P') return true;
+				}
+				unsigned int chr;
+				if (!parseEscapeSequence( chr, ei, ee, expr) || chr >= 0x80) return true;
+				continue;
+			}
+			case '.':
+				if (!inclass) return true;
+				break;
+			case '[':
+				if (inclass)
+				{
+					if (ei+1 < ee && ei[1] == ':' && ucp) return true;
+				}
+				else
+				{
+					inclass = true;
+					if (ei+1 < ee && ei[1] == '^') return true;
+					if (ei+1 < ee && ei[1] == ']') ++ei;	//... ']' as first character of a class is a literal
+				}
+				break;
+			case ']':
+				inclass = false;
+				break;
+			case '(':
+				if (!inclass && ei+1 < ee && ei[1] == '?')
+				{
+					//... option setting, caseless matching switched on in the expression
+					char const* oi = ei + 2;
+					for (; oi < ee && (isAsciiAlnum( *oi) || *oi == '-'); ++oi)
+					{
+						if (*oi == 'i' && ucp) return true;
+						if (*oi == '-') break;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+		++ei;
+	}
+	return false;
+}
+
+/// \brief Append a character of a regular expression mapped to lower case, the original sequence is appended if the character is not changed by the folding
+static void appendFoldedChar( std::string& res, unsigned int chr, const char* start, const char* end)
+{
+	unsigned int fc = foldCaseChar( chr);
+	if (fc == chr)
+	{
+		res.append( start, end - start);
+	}
+	else
+	{
+		utf8append( res, fc);
+	}
+}
+
+/// \brief Append a literal character of a regular expression mapped to lower case
+/// \param[in,out] ei pointer to the character, moved to its end
+static void appendFoldedLiteral( std::string& res, char const*& ei, const char* ee)
+{
+	std::size_t chrsize;
+	unsigned int chr = utf8decode( ei, ee - ei, chrsize);
+	if (!chrsize)
+	{
+		res.push_back( *ei++);
+	}
+	else
+	{
+		appendFoldedChar( res, chr, ei, ei + chrsize);
+		ei += chrsize;
+	}
+}
+
+/// \brief Append a bracket expression (character class) of a regular expression mapped to lower case
+/// \param[in,out] ei pointer to the opening bracket, moved to the end of the bracket expression
+/// \return false, if the class contains a range that can not be mapped to a range of lower case characters (e.g. '[Z-a]')
+static bool appendFoldedCharacterClass( std::string& res, char const*& ei, const char* ee, const std::string& expr)
+{
+	bool rt = true;
+	res.push_back( *ei++);
+	if (ei < ee && *ei == '^') res.push_back( *ei++);
+	bool first = true;
+	while (ei < ee && (*ei != ']' || first))
+	{
+		first = false;
+		if (*ei == '[' && ei+1 < ee && (ei[1] == ':' || ei[1] == '.' || ei[1] == '='))
+		{
+			//... POSIX character class, collating element or equivalence class
+			const char* start = ei;
+			char delim = ei[1];
+			std::string name;
+			for (ei += 2; ei+1 < ee && !(ei[0] == delim && ei[1] == ']'); ++ei) name.push_back( *ei);
+			ei = (ei+1 < ee) ? (ei + 2) : ee;
+			if (delim == ':' && isCaseDependentClassName( name))
+			{
+				throw strus::runtime_error(_TXT("option CASEFOLD is not applicable to the expression '%s' with a character class depending on case"), expr.c_str());
+			}
+			res.append( start, ei - start);
+			continue;
+		}
+		const char* start = ei;
+		unsigned int lo;
+		bool isChar;
+		if (*ei == '\\')
+		{
+			isChar = parseEscapeSequence( lo, ei, ee, expr);
+		}
+		else
+		{
+			std::size_t chrsize;
+			lo = utf8decode( ei, ee - ei, chrsize);
+			isChar = (chrsize != 0);
+			ei += chrsize ? chrsize : 1;
+		}
+		if (isChar && ei+1 < ee && *ei == '-' && ei[1] != ']')
+		{
+			//... character range
+			++ei;
+			unsigned int hi;
+			if (*ei == '\\')
+			{
+				isChar = parseEscapeSequence( hi, ei, ee, expr);
+			}
+			else
+			{
+				std::size_t chrsize;
+				hi = utf8decode( ei, ee - ei, chrsize);
+				isChar = (chrsize != 0);
+				ei += chrsize ? chrsize : 1;
+			}
+			int delta;
+			FoldCaseRangeClass rangeClass = (isChar && lo <= hi) ? foldCaseRange( lo, hi, delta) : FoldCaseRangeUnchanged;
+			if (rangeClass == FoldCaseRangeShifted)
+			{
+				utf8append( res, lo + delta);
+				res.push_back( '-');
+				utf8append( res, hi + delta);
+			}
+			else
+			{
+				if (rangeClass == FoldCaseRangeMixed) rt = false;
+				res.append( start, ei - start);
+			}
+		}
+		else if (isChar)
+		{
+			appendFoldedChar( res, lo, start, ei);
+		}
+		else
+		{
+			res.append( start, ei - start);
+		}
+	}
+	if (ei < ee) res.push_back( *ei++);
+	return rt;
+}
+
+/// \brief Append the header of a group starting with '(?' of a regular expression (option setting, group name, comment, etc.), the header is left as it is
+/// \param[in,out] ei pointer to the opening bracket, moved to the end of the header
+static void appendGroupHeader( std::string& res, char const*& ei, const char* ee)
+{
+	const char* start = ei;
+	ei += 2;
+	if (ei < ee)
+	{
+		char eb = 0;
+		if (*ei == '#')
+		{
+			eb = ')';
+		}
+		else if (*ei == '<' && ei+1 < ee && (ei[1] == '=' || ei[1] == '!'))
+		{
+			ei += 2;
+		}
+		else if (*ei == '<')
+		{
+			eb = '>';
+		}
+		else if (*ei == '\'')
+		{
+			++ei;
+			eb = '\'';
+		}
+		else if (*ei == 'P' && ei+1 < ee)
+		{
+			eb = (ei[1] == '<') ? '>' : ')';
+		}
+		else
+		{
+			//... option letters
+			for (; ei < ee && (isAsciiAlnum( *ei) || *ei == '-' || *ei == '^'); ++ei){}
+		}
+		if (eb)
+		{
+			for (; ei < ee && *ei != eb; ++ei){}
+			if (ei < ee) ++ei;
+		}
+	}
+	res.append( start, ei - start);
+}
+
+///\brief Map the characters of a regular expression to lower case with the simple case folding for matching a source mapped to lower case with a case sensitive automaton
+///\param[out] res the mapped expression
+///\param[in] expr the expression to map
+///\return true on success, false if the expression contains a character range that can not be mapped to a range of lower case characters (e.g. '[Z-a]' or '[À-ʯ]'), the mapped expression has to be matched caseless then
+///\remark Letters of escape sequences (e.g. '\W'), of option settings and of group names (e.g. '(?i)' or '(?<Name>') are left as they are, characters specified by their code (e.g. '\x{C4}') are mapped
+///\remark Throws for expressions with classes depending on case (e.g. '\p{Lu}' or '[[:upper:]]'), they can not match in a source mapped to lower case
+static bool foldCaseExpression( std::string& res, const std::string& expr)
+{
+	bool rt = true;
+	char const* ei = expr.c_str();
+	const char* ee = ei + expr.size();
+	res.clear();
+	while (ei < ee)
+	{
+		if (*ei == '\\' && ei+1 < ee && ei[1] == 'Q')
+		{
+			//... quoted literal string up to '\E'
+			res.append( ei, 2);
+			for (ei += 2; ei < ee && !(ei[0] == '\\' && ei+1 < ee && ei[1] == 'E');)
+			{
+				appendFoldedLiteral( res, ei, ee);
+			}
+		}
+		else if (*ei == '\\')
+		{
+			const char* start = ei;
+			unsigned int chr;
+			if (parseEscapeSequence( chr, ei, ee, expr))
+			{
+				appendFoldedChar( res, chr, start, ei);
+			}
+			else
+			{
+				res.append( start, ei - start);
+			}
+		}
+		else if (*ei == '[')
+		{
+			if (!appendFoldedCharacterClass( res, ei, ee, expr)) rt = false;
+		}
+		else if (*ei == '(' && ei+1 < ee && ei[1] == '?')
+		{
+			appendGroupHeader( res, ei, ee);
+		}
+		else
+		{
+			appendFoldedLiteral( res, ei, ee);
+		}
+	}
+	return rt;
+}
+
+/// \brief Match of a lexem not reported by the hyperscan scan of the exact lexems (gazetteer or edit distance database), merged by end position into the matches of this scan
+struct LexemMatch
+{
+	uint32_t patternidx;
+	uint32_t from;
+	uint32_t to;
+
+	LexemMatch( uint32_t patternidx_, uint32_t from_, uint32_t to_)
+		:patternidx(patternidx_),from(from_),to(to_){}
+	LexemMatch( const LexemMatch& o)
+		:patternidx(o.patternidx),from(o.from),to(o.to){}
+
+	bool operator<( const LexemMatch& o) const
+	{
+		return (to == o.to) ? (patternidx < o.patternidx) : (to < o.to);
+	}
+};
+
+///\brief Dictionary of plain string lexems stored in a compact trie, matched without the hyperscan engine
+///\remark The keys are collected in a compact trie, the scanner is an Aho-Corasick automaton built from it with compile, matching in one pass over the source in O(n + number of matches)
+class GazetteerTable
+{
+public:
+	GazetteerTable()
+		:m_trie(),m_entryar(),m_statear(),m_edgear()
+	{
+		std::memset( m_rootnext, 0, sizeof(m_rootnext));
+	}
+
+	void define( const std::string& key, uint32_t patternidx, bool wordBoundStart, bool wordBoundEnd)
+	{
+		if (m_entryar.size() >= (std::size_t)std::numeric_limits<uint32_t>::max()-1)
+		{
+			throw strus::runtime_error(_TXT("too many gazetteer entries defined"));
+		}
+		if (!m_statear.empty())
+		{
+			throw strus::runtime_error(_TXT("gazetteer entry defined after compile"));
+		}
+		uint32_t entryidx = m_entryar.size()+1;
+		conotrie::CompactNodeTrie::NodeData headidx;
+		if (m_trie.get( key.c_str(), headidx))
+		{
+			// ... key already defined, link the new entry to the list of the key:
+			m_entryar.push_back( Entry( patternidx, wordBoundStart, wordBoundEnd, m_entryar[ headidx-1].next));
+			m_entryar[ headidx-1].next = entryidx;
+		}
+		else
+		{
+			m_entryar.push_back( Entry( patternidx, wordBoundStart, wordBoundEnd, 0));
+			if (!m_trie.set( key.c_str(), entryidx))
+			{
+				throw strus::runtime_error(_TXT("too many gazetteer entries defined (trie capacity exhausted)"));
+			}
+		}
+	}
+
+	bool empty() const
+	{
+		return m_entryar.empty();
+	}
+
+	///\brief Build the Aho-Corasick automaton from the keys defined and release the trie
+	void compile()
+	{
+		std::vector<std::map<unsigned char,uint32_t> > gotoar( 1);
+		std::vector<State> statear( 1);
+		conotrie::CompactNodeTrie::const_iterator ti = m_trie.begin(), te = m_trie.end();
+		for (; ti != te; ++ti)
+		{
+			const std::string& key = ti.key();
+			uint32_t state = 0;
+			std::string::const_iterator ki = key.begin(), ke = key.end();
+			for (; ki != ke; ++ki)
+			{
+				std::map<unsigned char,uint32_t>::const_iterator gi = gotoar[ state].find( (unsigned char)*ki);
+				if (gi == gotoar[ state].end())
+				{
+					uint32_t follow = statear.size();
+					gotoar[ state][ (unsigned char)*ki] = follow;
+					gotoar.push_back( std::map<unsigned char,uint32_t>());
+					statear.push_back( State( statear[ state].depth + 1));
+					state = follow;
+				}
+				else
+				{
+					state = gi->second;
+				}
+			}
+			statear[ state].entryidx = ti.data();
+		}
+		// Flatten the goto function into one array of edges sorted by character per state:
+		std::vector<Edge> edgear;
+		std::size_t sidx = 0;
+		for (; sidx < statear.size(); ++sidx)
+		{
+			statear[ sidx].edgestart = edgear.size();
+			std::map<unsigned char,uint32_t>::const_iterator gi = gotoar[ sidx].begin(), ge = gotoar[ sidx].end();
+			for (; gi != ge; ++gi)
+			{
+				edgear.push_back( Edge( gi->first, gi->second));
+			}
+			statear[ sidx].edgeend = edgear.size();
+		}
+		// Calculate the failure links and the links to the next state with output on the failure chain in breadth first order:
+		std::vector<uint32_t> queue;
+		queue.reserve( statear.size());
+		std::size_t ei = statear[0].edgestart, ee = statear[0].edgeend;
+		for (; ei != ee; ++ei)
+		{
+			m_rootnext[ edgear[ ei].chr] = edgear[ ei].next;
+			queue.push_back( edgear[ ei].next);
+		}
+		std::size_t qi = 0;
+		for (; qi < queue.size(); ++qi)
+		{
+			uint32_t state = queue[ qi];
+			for (ei = statear[ state].edgestart, ee = statear[ state].edgeend; ei != ee; ++ei)
+			{
+				uint32_t follow = edgear[ ei].next;
+				uint32_t fail = nextState( statear, edgear, statear[ state].fail, edgear[ ei].chr);
+				statear[ follow].fail = fail;
+				statear[ follow].outlink = statear[ fail].entryidx ? fail : statear[ fail].outlink;
+				queue.push_back( follow);
+			}
+		}
+		m_statear.swap( statear);
+		m_edgear.swap( edgear);
+		m_trie.clear();
+	}
+
+	///\brief Get all matches of keys in a source, ordered by end position like hyperscan reports them
+	void scan( std::vector<LexemMatch>& res, const char* src, std::size_t srclen) const
+	{
+		if (m_statear.empty()) return;
+		const unsigned char* us = (const unsigned char*)src;
+
+		uint32_t state = 0;
+		std::size_t si = 0;
+		for (; si < srclen; ++si)
+		{
+			state = nextState( m_statear, m_edgear, state, us[ si]);
+			const State& st = m_statear[ state];
+			if (st.entryidx || st.outlink)
+			{
+				std::size_t start = res.size();
+				uint32_t ostate = st.entryidx ? state : st.outlink;
+				for (; ostate; ostate = m_statear[ ostate].outlink)
+				{
+					std::size_t from = si + 1 - m_statear[ ostate].depth;
+					bool atWordBoundStart = isWordBoundary( us, srclen, from);
+					bool atWordBoundEnd = isWordBoundary( us, srclen, si + 1);
+					uint32_t entryidx = m_statear[ ostate].entryidx;
+					for (; entryidx; entryidx = m_entryar[ entryidx-1].next)
+					{
+						const Entry& entry = m_entryar[ entryidx-1];
+						if (entry.wordBoundStart && !atWordBoundStart) continue;
+						if (entry.wordBoundEnd && !atWordBoundEnd) continue;
+						res.push_back( LexemMatch( entry.patternidx, from, si + 1));
+					}
+				}
+				//... matches with the same end position ordered by pattern:
+				if (res.size() - start > 1) std::sort( res.begin() + start, res.end());
+			}
+		}
+	}
+
+private:
+	struct Entry
+	{
+		uint32_t patternidx;
+		uint32_t next;
+		bool wordBoundStart;
+		bool wordBoundEnd;
+
+		Entry( uint32_t patternidx_, bool wordBoundStart_, bool wordBoundEnd_, uint32_t next_)
+			:patternidx(patternidx_),next(next_),wordBoundStart(wordBoundStart_),wordBoundEnd(wordBoundEnd_){}
+		Entry( const Entry& o)
+			:patternidx(o.patternidx),next(o.next),wordBoundStart(o.wordBoundStart),wordBoundEnd(o.wordBoundEnd){}
+	};
+	struct State
+	{
+		uint32_t edgestart;		///< start of the edges of the state in m_edgear
+		uint32_t edgeend;		///< end of the edges of the state in m_edgear
+		uint32_t fail;			///< state of the longest proper suffix of the key prefix of this state
+		uint32_t outlink;		///< next state with entries on the failure chain or 0
+		uint32_t entryidx;		///< index of the first element in m_entryar + 1 of the key ending in this state or 0
+		uint32_t depth;			///< length of the key prefix of this state
+
+		explicit State( uint32_t depth_=0)
+			:edgestart(0),edgeend(0),fail(0),outlink(0),entryidx(0),depth(depth_){}
+		State( const State& o)
+			:edgestart(o.edgestart),edgeend(o.edgeend),fail(o.fail),outlink(o.outlink),entryidx(o.entryidx),depth(o.depth){}
+	};
+	struct Edge
+	{
+		unsigned char chr;
+		uint32_t next;
+
+		Edge( unsigned char chr_, uint32_t next_)
+			:chr(chr_),next(next_){}
+		Edge( const Edge& o)
+			:chr(o.chr),next(o.next){}
+
+		bool operator<( const Edge& o) const
+		{
+			return chr < o.chr;
+		}
+	};
+
+	uint32_t nextState( const std::vector<State>& statear, const std::vector<Edge>& edgear, uint32_t state, unsigned char chr) const
+	{
+		while (state)
+		{
+			const State& st = statear[ state];
+			std::vector<Edge>::const_iterator
+				ei = edgear.begin() + st.edgestart,
+				ee = edgear.begin() + st.edgeend;
+			ei = std::lower_bound( ei, ee, Edge( chr, 0));
+			if (ei != ee && ei->chr == chr) return ei->next;
+			state = st.fail;
+		}
+		return m_rootnext[ chr];
+	}
+
+private:
+	conotrie::CompactNodeTrie m_trie;	///< map key -> index of the first element in m_entryar + 1, released by compile
+	std::vector<Entry> m_entryar;		///< list of lexem definitions assigned to a key
+	std::vector<State> m_statear;		///< states of the Aho-Corasick automaton, 0 is the root
+	std::vector<Edge> m_edgear;		///< transitions of the states of the automaton
+	uint32_t m_rootnext[ 256];		///< transitions of the root state for every character (0 for staying in the root)
+};
+
+
+/// \brief Match state of an operand of lexem combinations in a lexer context
+struct CombinationOperandMatch
+{
+	unsigned_long_long from;	///< start of the operand match with the biggest start position
+	bool matched;			///< true, if the operand has a match in the source scanned
+
+	CombinationOperandMatch()
+		:from(0),matched(false){}
+	CombinationOperandMatch( const CombinationOperandMatch& o)
+		:from(o.from),matched(o.matched){}
+};
+
+///\brief Lexems defined as logical combination of other lexems, evaluated by the lexer on the matches of their operands
+///\remark A combination is evaluated at the end of every match of one of its operands. An operand is true there, if it has a match ending before or at this position and starting at most 'span' bytes before it. The match of a combination reaches from the start of the first operand match not negated to the end of the operand match that made it true.
+class CombinationTable
+{
+public:
+	/// \brief Instructions of the postfix programs evaluating a combination, values >= 0 stand for the operand with this index
+	enum Instruction {OpAnd=-1, OpOr=-2, OpNot=-3};
+	/// \brief Maximum depth of the stack needed for evaluating a combination
+	enum {MaxStackDepth=64};
+	/// \brief Map lexem identifier -> indices of the lexems (pattern index - 1) defined with it
+	typedef std::map<unsigned int,std::vector<std::size_t> > IdIndexMap;
+
+	struct Combination
+	{
+		uint32_t patternidx;		///< index of the lexem defined as combination
+		uint32_t span;			///< maximum distance in bytes from the start of the first to the end of the last operand match
+		uint32_t progidx;		///< start of the program evaluating the combination in m_programar
+		uint32_t progsize;		///< number of instructions of the program
+		uint32_t positiveidx;		///< start of the list of operands not negated in m_positivear
+		uint32_t positivesize;		///< number of operands not negated
+
+		Combination( uint32_t patternidx_, uint32_t span_, uint32_t progidx_, uint32_t positiveidx_)
+			:patternidx(patternidx_),span(span_),progidx(progidx_),progsize(0),positiveidx(positiveidx_),positivesize(0){}
+		Combination( const Combination& o)
+			:patternidx(o.patternidx),span(o.span),progidx(o.progidx),progsize(o.progsize),positiveidx(o.positiveidx),positivesize(o.positivesize){}
+	};
+
+	CombinationTable()
+		:m_combinationar(),m_programar(),m_positivear(),m_operandar(),m_triggerar(),m_idOperandMap(){}
+
+	/// \brief Define a combination
+	/// \param[in] patternidx index of the lexem defined as combination
+	/// \param[in] expression logical expression with the operators '&' (and), '|' (or), '!' (not) and brackets on lexem identifiers
+	/// \param[in] span maximum distance in bytes from the start of the first to the end of the last operand match
+	/// \param[in] idmap map lexem identifier -> indices of the lexems defined with it
+	/// \param[in] nofPatterns number of lexems defined
+	/// \param[in,out] isOperand flag for every lexem, set if the lexem is referenced in a combination
+	void define( uint32_t patternidx, const std::string& expression, unsigned int span, const IdIndexMap& idmap, std::size_t nofPatterns, std::vector<bool>& isOperand)
+	{
+		if (m_programar.size() + expression.size() >= (std::size_t)std::numeric_limits<uint32_t>::max())
+		{
+			throw strus::runtime_error(_TXT("too many lexem combinations defined"));
+		}
+		m_operandar.resize( nofPatterns, 0);
+		m_combinationar.push_back( Combination( patternidx, span, m_programar.size(), m_positivear.size()));
+		ParserState state( expression.c_str(), idmap, isOperand);
+		parseOr( state, false);
+		skipSpaces( state.itr);
+		if (*state.itr)
+		{
+			throw strus::runtime_error(_TXT("syntax error in lexem combination '%s' at '%s'"), state.expr, state.itr);
+		}
+		Combination& comb = m_combinationar.back();
+		comb.progsize = m_programar.size() - comb.progidx;
+		comb.positivesize = m_positivear.size() - comb.positiveidx;
+		if (stackDepth( comb) > (unsigned int)MaxStackDepth)
+		{
+			throw strus::runtime_error(_TXT("lexem combination '%s' too complex"), state.expr);
+		}
+		//... a combination is only evaluated at operand matches, so it must not be true without any operand match
+		std::vector<CombinationOperandMatch> nomatch( m_triggerar.size());
+		unsigned_long_long from;
+		if (match( comb, &nomatch[0], 0, from))
+		{
+			throw strus::runtime_error(_TXT("lexem combination '%s' is true without any operand match"), state.expr);
+		}
+		//... the combination is evaluated at every match of one of its operands:
+		std::set<int32_t> operands( m_programar.begin() + comb.progidx, m_programar.end());
+		std::set<int32_t>::const_iterator oi = operands.begin(), oe = operands.end();
+		for (; oi != oe; ++oi)
+		{
+			if (*oi >= 0) m_triggerar[ *oi].push_back( m_combinationar.size()-1);
+		}
+	}
+
+	/// \brief Release the data only needed for defining combinations
+	void releaseSources()
+	{
+		IdOperandMap().swap( m_idOperandMap);
+	}
+
+	bool empty() const
+	{
+		return m_combinationar.empty();
+	}
+
+	/// \brief Get the number of operands of all combinations
+	std::size_t nofOperands() const
+	{
+		return m_triggerar.size();
+	}
+
+	/// \brief Get the number of combinations defined
+	std::size_t size() const
+	{
+		return m_combinationar.size();
+	}
+
+	/// \brief Get the index of the operand a lexem stands for
+	/// \return the operand index + 1 or 0 if the lexem is not an operand of a combination
+	unsigned int operand( unsigned int patternidx) const
+	{
+		return m_operandar.empty() ? 0 : m_operandar[ patternidx-1];
+	}
+
+	/// \brief Get the list of combinations evaluated with a match of an operand
+	const std::vector<uint32_t>& triggers( unsigned int operandidx) const
+	{
+		return m_triggerar[ operandidx];
+	}
+
+	const Combination& combination( std::size_t cidx) const
+	{
+		return m_combinationar[ cidx];
+	}
+
+	/// \brief Evaluate a combination at the end of an operand match
+	/// \param[in] comb the combination to evaluate
+	/// \param[in] operandar match state of all operands
+	/// \param[in] to end of the operand match the combination is evaluated at
+	/// \param[out] from start of the match of the combination
+	/// \return true, if the combination is true
+	bool match( const Combination& comb, const CombinationOperandMatch* operandar, unsigned_long_long to, unsigned_long_long& from) const
+	{
+		unsigned_long_long windowstart = to > comb.span ? to - comb.span : 0;
+		bool stack[ MaxStackDepth];
+		std::size_t sp = 0;
+		std::vector<int32_t>::const_iterator pi = m_programar.begin() + comb.progidx, pe = pi + comb.progsize;
+		for (; pi != pe; ++pi)
+		{
+			switch (*pi)
+			{
+				case OpAnd:
+					--sp;
+					stack[ sp-1] = stack[ sp-1] && stack[ sp];
+					break;
+				case OpOr:
+					--sp;
+					stack[ sp-1] = stack[ sp-1] || stack[ sp];
+					break;
+				case OpNot:
+					stack[ sp-1] = !stack[ sp-1];
+					break;
+				default:
+				{
+					const CombinationOperandMatch& om = operandar[ *pi];
+					stack[ sp++] = om.matched && om.from >= windowstart;
+				}
+			}
+		}
+		if (!stack[ 0]) return false;
+		from = to;
+		std::vector<uint32_t>::const_iterator oi = m_positivear.begin() + comb.positiveidx, oe = oi + comb.positivesize;
+		for (; oi != oe; ++oi)
+		{
+			const CombinationOperandMatch& om = operandar[ *oi];
+			if (om.matched && om.from >= windowstart && om.from < from) from = om.from;
+		}
+		return true;
+	}
+
+private:
+	struct ParserState
+	{
+		const char* expr;
+		char const* itr;
+		const IdIndexMap& idmap;
+		std::vector<bool>& isOperand;
+
+		ParserState( const char* expr_, const IdIndexMap& idmap_, std::vector<bool>& isOperand_)
+			:expr(expr_),itr(expr_),idmap(idmap_),isOperand(isOperand_){}
+	};
+
+	static void skipSpaces( char const*& si)
+	{
+		for (; *si == ' ' || *si == '\t'; ++si){}
+	}
+
+	void parseOr( ParserState& state, bool negated)
+	{
+		parseAnd( state, negated);
+		for (skipSpaces( state.itr); *state.itr == '|'; skipSpaces( state.itr))
+		{
+			++state.itr;
+			parseAnd( state, negated);
+			m_programar.push_back( OpOr);
+		}
+	}
+
+	void parseAnd( ParserState& state, bool negated)
+	{
+		parseFactor( state, negated);
+		for (skipSpaces( state.itr); *state.itr == '&'; skipSpaces( state.itr))
+		{
+			++state.itr;
+			parseFactor( state, negated);
+			m_programar.push_back( OpAnd);
+		}
+	}
+
+	void parseFactor( ParserState& state, bool negated)
+	{
+		skipSpaces( state.itr);
+		if (*state.itr == '!')
+		{
+			++state.itr;
+			parseFactor( state, !negated);
+			m_programar.push_back( OpNot);
+		}
+		else if (*state.itr == '(')
+		{
+			++state.itr;
+			parseOr( state, negated);
+			skipSpaces( state.itr);
+			if (*state.itr != ')')
+			{
+				throw strus::runtime_error(_TXT("syntax error in lexem combination '%s' at '%s'"), state.expr, state.itr);
+			}
+			++state.itr;
+		}
+		else if (*state.itr >= '0' && *state.itr <= '9')
+		{
+			unsigned int id = 0;
+			for (; *state.itr >= '0' && *state.itr <= '9'; ++state.itr)
+			{
+				id = id * 10 + (*state.itr - '0');
+				if (id > MaxPatternId) throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "pattern id", MaxPatternId);
+			}
+			IdIndexMap::const_iterator ii = state.idmap.find( id);
+			if (ii == state.idmap.end())
+			{
+				throw strus::runtime_error(_TXT("lexem %u referenced in combination '%s' is not defined as regular expression"), id, state.expr);
+			}
+			uint32_t operandidx = getOperand( id, ii->second, state.isOperand);
+			m_programar.push_back( operandidx);
+			if (!negated) m_positivear.push_back( operandidx);
+		}
+		else
+		{
+			throw strus::runtime_error(_TXT("syntax error in lexem combination '%s' at '%s'"), state.expr, state.itr);
+		}
+	}
+
+	/// \brief Get the operand a lexem identifier stands for, an operand stands for the alternatives of all lexems defined with the identifier
+	uint32_t getOperand( unsigned int id, const std::vector<std::size_t>& didxar, std::vector<bool>& isOperand)
+	{
+		IdOperandMap::const_iterator oi = m_idOperandMap.find( id);
+		if (oi != m_idOperandMap.end()) return oi->second;
+
+		uint32_t rt = m_triggerar.size();
+		m_idOperandMap[ id] = rt;
+		m_triggerar.push_back( std::vector<uint32_t>());
+		std::vector<std::size_t>::const_iterator di = didxar.begin(), de = didxar.end();
+		for (; di != de; ++di)
+		{
+			m_operandar[ *di] = rt+1;
+			isOperand[ *di] = true;
+		}
+		return rt;
+	}
+
+	unsigned int stackDepth( const Combination& comb) const
+	{
+		unsigned int rt = 0;
+		unsigned int sp = 0;
+		std::vector<int32_t>::const_iterator pi = m_programar.begin() + comb.progidx, pe = pi + comb.progsize;
+		for (; pi != pe; ++pi)
+		{
+			if (*pi >= 0)
+			{
+				if (++sp > rt) rt = sp;
+			}
+			else if (*pi != OpNot)
+			{
+				--sp;
+			}
+		}
+		return rt;
+	}
+
+private:
+	std::vector<Combination> m_combinationar;		///< list of combinations defined
+	std::vector<int32_t> m_programar;			///< postfix programs evaluating the combinations, referenced by Combination::progidx
+	std::vector<uint32_t> m_positivear;			///< operands not negated of the combinations, referenced by Combination::positiveidx
+	std::vector<uint32_t> m_operandar;			///< operand index + 1 of every lexem (pattern index - 1), 0 if the lexem is not an operand, empty if there are no combinations
+	std::vector<std::vector<uint32_t> > m_triggerar;	///< list of the combinations referencing an operand, for every operand index
+	typedef std::map<unsigned int,uint32_t> IdOperandMap;
+	IdOperandMap m_idOperandMap;				///< map lexem identifier -> operand index, only needed for defining combinations
+};
 
 class PatternTable
 {
 public:
 	explicit PatternTable( ErrorBufferInterface* errorhnd_)
-		:m_errorhnd(errorhnd_),m_hasEditDist(false){}
+		:m_errorhnd(errorhnd_),m_defar(),m_srcar(),m_exprpool(),m_referencedIdSet(),m_hasReferencedIdSet(false),m_combinations(),m_duplicatear(),m_hasEditDist(false),m_hasCombination(false),m_released(false){}
 
 	void definePattern(
 			unsigned int id,
@@ -241,22 +1300,106 @@ public:
 			analyzer::PositionBind posbind)
 	{
 		std::string expression( expression_);
-		unsigned int editdist = extractEditDistFromExpression( expression);
+		bool hamming = false;
+		unsigned int editdist = extractEditDistFromExpression( expression, hamming);
 #ifdef STRUS_LOWLEVEL_DEBUG
 		std::cout << "define pattern " << id << " index " << (m_defar.size()+1)
 				<< " '" << expression;
 		if (subexpref) std::cout << "', select part " << subexpref;
 		std::cout << "', level " << level;
 		std::cout << ", resultidx " << resultIndex;
-		std::cout << ", editdist " << editdist;
+		std::cout << (hamming ? ", hamming " : ", editdist ") << editdist;
 		std::cout << ", posbind " << ((int)(posbind+1) % 3 - 1);
 		std::cout << std::endl;
 #endif
-		m_defar.push_back( PatternDef( expression, 0/*subexpref*/, id, posbind, level, resultIndex, editdist));
-		if (m_defar.size() > std::numeric_limits<uint32_t>::max())
+		if (m_defar.size() >= std::numeric_limits<uint32_t>::max())
+		{
+			throw strus::runtime_error(_TXT("too many patterns defined, maximum %u allowed"), (unsigned int)std::numeric_limits<uint32_t>::max());
+		}
+		if (m_released)
+		{
+			throw strus::runtime_error(_TXT("called define pattern after calling 'compile'"));
+		}
+		PatternSource source( m_exprpool.size(), expression.size(), resultIndex, editdist, hamming);
+		PatternDef def( 0/*subexpref*/, id, posbind, level);
+		m_srcar.push_back( source);
+		m_defar.push_back( def);
+		m_exprpool.append( expression);
+		m_exprpool.push_back( '\0');
+	}
+
+	/// \brief Define a lexem as logical combination of other lexems, evaluated on the matches of the lexems combined
+	/// \param[in] expression logical expression with the operators '&' (and), '|' (or), '!' (not) and brackets on the identifiers of the lexems combined
+	/// \param[in] span maximum distance in bytes from the start of the first to the end of the last match of the lexems combined
+	void defineCombination(
+			unsigned int id,
+			const std::string& expression,
+			unsigned int span,
+			unsigned int level,
+			analyzer::PositionBind posbind)
+	{
+		if (span == 0)
+		{
+			throw strus::runtime_error(_TXT("%s out of range, It must be a positive integer in the range 1..%u"), "span of lexem combination", (unsigned int)MaxCombinationSpan);
+		}
+		if (m_defar.size() >= std::numeric_limits<uint32_t>::max())
 		{
 			throw strus::runtime_error(_TXT("too many patterns defined, maximum %u allowed"), (unsigned int)std::numeric_limits<uint32_t>::max());
 		}
+		if (m_released)
+		{
+			throw strus::runtime_error(_TXT("called define pattern after calling 'compile'"));
+		}
+		if (expression.empty() || expression.find_first_not_of( "0123456789&|!() \t") != std::string::npos)
+		{
+			throw strus::runtime_error(_TXT("invalid lexem combination '%s', only lexem identifiers, the operators '&', '|', '!' and brackets allowed"), expression.c_str());
+		}
+		PatternSource source( m_exprpool.size(), expression.size(), 0/*resultidx*/, 0/*editdist*/, false/*hamming*/, span);
+		PatternDef def( 0/*subexpref*/, id, posbind, level);
+		m_srcar.push_back( source);
+		m_defar.push_back( def);
+		m_exprpool.append( expression);
+		m_exprpool.push_back( '\0');
+	}
+
+	/// \brief Declare lexem identifiers as referenced by the consumer of the lexems (e.g. a pattern matcher), other lexems are not reported if they do not influence the result
+	void defineReferencedLexems( const std::vector<unsigned int>& ids)
+	{
+		if (m_released)
+		{
+			throw strus::runtime_error(_TXT("called define referenced lexems after calling 'compile'"));
+		}
+		m_referencedIdSet.insert( ids.begin(), ids.end());
+		m_hasReferencedIdSet = true;
+	}
+
+	/// \brief Get the identifiers of all lexems and symbols defined
+	void getVocabulary( std::vector<unsigned int>& res) const
+	{
+		std::set<unsigned int> idset;
+		std::vector<PatternDef>::const_iterator di = m_defar.begin(), de = m_defar.end();
+		for (; di != de; ++di)
+		{
+			if (di->id()) idset.insert( di->id());
+		}
+		idset.insert( m_symidmap.begin(), m_symidmap.end());
+		res.insert( res.end(), idset.begin(), idset.end());
+	}
+
+	/// \brief Get the regular expression string of a pattern defined (only available before calling releaseSources())
+	std::string expression( std::size_t didx) const
+	{
+		const PatternSource& src = m_srcar[ didx];
+		return std::string( m_exprpool.c_str() + src.exprpos(), src.exprsize());
+	}
+
+	/// \brief Free all data not needed anymore after the automaton has been built with the HsPatternTable returned by complete
+	void releaseSources()
+	{
+		std::vector<PatternSource>().swap( m_srcar);
+		std::string().swap( m_exprpool);
+		std::vector<PatternDef>( m_defar).swap( m_defar);
+		m_released = true;
 	}
 
 	void defineSymbol( uint32_t symbolid, unsigned int patternid, const std::string& name)
@@ -318,89 +1461,247 @@ public:
 		return m_defar[ id-1];
 	}
 
-	hs_expr_ext_t* createPatternExprExtFlags( unsigned int edit_distance)
+	/// \brief Get the index of the next pattern defined with the same regular expression as the pattern with index patternIdx, reported by hyperscan only with the index of the first of them
+	/// \return the index or 0 if there is none
+	unsigned int nextDuplicate( unsigned int patternIdx) const
+	{
+		return m_duplicatear.empty() ? 0 : m_duplicatear[ patternIdx-1];
+	}
+
+	/// \brief Get the number of patterns defined
+	std::size_t size() const
+	{
+		return m_defar.size();
+	}
+
+	hs_expr_ext_t* createPatternExprExtFlags( unsigned int edit_distance, bool hamming)
 	{
 		hs_expr_ext_t* rt = (hs_expr_ext_t*)std::calloc( 1, sizeof( hs_expr_ext_t));
 		if (rt == 0) throw std::bad_alloc();
+#ifdef HS_EXT_FLAG_HAMMING_DISTANCE
+		if (hamming)
+		{
+			rt->flags = HS_EXT_FLAG_HAMMING_DISTANCE;
+			rt->hamming_distance = edit_distance;
+			return rt;
+		}
+#endif
+		//... without support of Hamming distance in hyperscan, edit distance is used as prematch, the verifier only accepts substitutions
 		rt->flags = HS_EXT_FLAG_EDIT_DISTANCE;
 		rt->edit_distance = edit_distance;
 		return rt;
 	}
+	///\param[out] hspt table of the exact lexems to build the hyperscan database scanning the UTF-8 source from
+	///\param[out] hspt_editdist table of the lexems with edit distance to build the hyperscan database scanning the source mapped to a one byte character set from
 	///\param[in] options options to stear matching
-	void complete( HsPatternTable& hspt, unsigned int options)
+	///\param[in] useGazetteer true, if plain string lexems should be matched with the gazetteer instead of hyperscan
+	///\param[in] casefold true, if the expressions should be mapped to lower case for matching a source mapped to lower case with a case sensitive automaton
+	void complete( HsPatternTable& hspt, HsPatternTable& hspt_editdist, unsigned int options, bool useGazetteer, bool casefold)
 	{
-		std::vector<PatternDef>::iterator di = m_defar.begin(), de = m_defar.end();
-		for (; di != de; ++di)
+		if (m_released)
 		{
-			if (di->editdist()) break;
+			throw strus::runtime_error(_TXT("called 'compile' twice"));
 		}
-		m_hasEditDist = (di != de);
-		if (m_hasEditDist)
+		// Flags of the expressions matched caseless:
+		std::vector<bool> isCaseless( m_defar.size(), (options & HS_FLAG_CASELESS) != 0);
+		if (casefold)
 		{
-			//... always do rematch expression in case of using edit dist because a match is only a hint:
-			std::vector<PatternDef>::iterator di = m_defar.begin(), de = m_defar.end();
-			for (; di != de; ++di)
+			//... the string pool is rebuilt, because folding may change the size of an expression:
+			std::string exprpool;
+			std::vector<PatternSource> srcar;
+			srcar.reserve( m_srcar.size());
+			std::vector<PatternSource>::const_iterator si = m_srcar.begin(), se = m_srcar.end();
+			for (std::size_t didx=0; si != se; ++si,++didx)
 			{
-				SubExpressionReference ref( new SubExpressionDef( di->expression(), di->resultidx(), di->editdist(), true/*wchar matching*/));
-				m_subexprmap.push_back( ref);
-				di->setSubExpressionRef( m_subexprmap.size());
+				std::string expr( expression( didx));
+				std::string folded;
+				if (si->combination())
+				{
+					folded = expr;
+					isCaseless[ didx] = false;
+				}
+				else
+				{
+					//... an expression with a character range that can not be mapped to lower case is matched caseless on the folded source
+					isCaseless[ didx] = !foldCaseExpression( folded, expr);
+				}
+				srcar.push_back( PatternSource( exprpool.size(), folded.size(), si->resultidx(), si->editdist(), si->hamming(), si->combinationSpan()));
+				exprpool.append( folded);
+				exprpool.push_back( '\0');
 			}
+			m_exprpool.swap( exprpool);
+			m_srcar.swap( srcar);
+			options &= ~HS_FLAG_CASELESS;
 		}
-		else
+		// Compile the logical combinations of lexem identifiers into programs evaluated on the matches of the lexems combined:
+		std::vector<bool> isCombinationOperand( m_defar.size(), false);
+		m_hasCombination = compileCombinations( isCombinationOperand);
+
+		// Evaluate the lexems not referenced that can be left out:
+		std::vector<bool> isUnreferenced( m_defar.size(), false);
+		if (m_hasReferencedIdSet)
 		{
-			//... do rematch expression that select a subexpression:
-			std::vector<PatternDef>::iterator di = m_defar.begin(), de = m_defar.end();
-			for (; di != de; ++di)
+			markUnreferencedLexems( isUnreferenced, isCombinationOperand);
+		}
+
+		// Move plain string lexems to the gazetteer, if enabled:
+		std::vector<bool> isGazetteerDef( m_defar.size(), false);
+		std::size_t nofGazetteerDefs = 0;
+		if (useGazetteer && (options & HS_FLAG_CASELESS) == 0)
+		{
+			std::vector<PatternSource>::const_iterator si = m_srcar.begin(), se = m_srcar.end();
+			for (std::size_t didx=0; si != se; ++si,++didx)
 			{
-				if (di->resultidx() != 0)
+				if (si->editdist() || si->resultidx() || si->combination() || isCombinationOperand[ didx] || isUnreferenced[ didx] || isCaseless[ didx]) continue;
+				std::string literal;
+				bool wordBoundStart;
+				bool wordBoundEnd;
+				if (parseLiteralExpression( literal, wordBoundStart, wordBoundEnd, expression( didx))
+				&&  (!(options & HS_FLAG_UCP) || (!wordBoundStart && !wordBoundEnd)))
 				{
-					SubExpressionReference ref( new SubExpressionDef( di->expression(), di->resultidx(), di->editdist(), false/*byte matching*/));
-					m_subexprmap.push_back( ref);
-					di->setSubExpressionRef( m_subexprmap.size());
+					m_gazetteer.define( literal, didx+1, wordBoundStart, wordBoundEnd);
+					isGazetteerDef[ didx] = true;
+					++nofGazetteerDefs;
 				}
 			}
+			if (nofGazetteerDefs) m_gazetteer.compile();
 		}
-		hspt.init( m_defar.size());
-		di = m_defar.begin();
-		for (std::size_t didx=0; di != de; ++di,++didx)
+		// Create the rematch expressions:
+		std::size_t nofEditDistDefs = 0;
+		std::vector<PatternSource>::const_iterator si = m_srcar.begin(), se = m_srcar.end();
+		for (std::size_t didx=0; si != se; ++si,++didx)
 		{
-			const char* expr;
-			if (m_hasEditDist)
+			if (isUnreferenced[ didx]) continue;
+			if (si->editdist())
+			{
+				//... always do rematch expression in case of using edit dist because a match is only a hint:
+				SubExpressionReference ref( new SubExpressionDef( expression( didx), si->resultidx(), si->editdist(), si->hamming(), isCaseless[ didx], true/*wchar matching*/));
+				m_subexprmap.push_back( ref);
+				m_defar[ didx].setSubExpressionRef( m_subexprmap.size());
+				++nofEditDistDefs;
+			}
+			else if (si->resultidx() != 0)
 			{
-				di->setExpressionOneByteCharMap();
-				expr = di->expression_onebyte().c_str();
+				//... do rematch expression that select a subexpression:
+				SubExpressionReference ref( new SubExpressionDef( expression( didx), si->resultidx(), si->editdist(), false/*hamming*/, isCaseless[ didx], false/*byte matching*/));
+				m_subexprmap.push_back( ref);
+				m_defar[ didx].setSubExpressionRef( m_subexprmap.size());
 			}
-			else
+		}
+		m_hasEditDist = (nofEditDistDefs > 0);
+		hspt.init( m_defar.size() - nofGazetteerDefs - nofEditDistDefs);
+		hspt_editdist.init( nofEditDistDefs);
+
+		std::vector<std::size_t> exprposar;
+		if (m_hasEditDist)
+		{
+			//... map edit distance expressions down to a one byte character set, stored in the string pool of the edit distance hyperscan table:
+			exprposar.reserve( m_srcar.size());
+			si = m_srcar.begin();
+			for (; si != se; ++si)
 			{
-				expr = di->expression().c_str();
+				exprposar.push_back( hspt_editdist.exprpool.size());
+				if (!si->editdist()) continue;
+				OneByteCharMap obcmap;
+				obcmap.init( m_exprpool.c_str() + si->exprpos(), si->exprsize());
+				hspt_editdist.exprpool.append( obcmap.value);
+				hspt_editdist.exprpool.push_back( '\0');
 			}
+		}
+		// Identical expressions are compiled only once, a match is fanned out to all lexems defined with the expression, linked in m_duplicatear:
+		typedef std::map<std::string,std::pair<std::size_t,std::size_t> > ExpressionMap;
+		ExpressionMap exprmap;				// expression -> index of the first and the last lexem defined with it
+		std::size_t nofDuplicates = 0;
+		m_duplicatear.assign( m_defar.size(), 0);
+
+		std::size_t hsidx = 0;
+		std::size_t edidx = 0;
+		std::vector<PatternDef>::iterator di = m_defar.begin(), de = m_defar.end();
+		si = m_srcar.begin();
+		for (std::size_t didx=0; di != de; ++di,++si,++didx)
+		{
 			IdSymTabMap::const_iterator ti = m_idsymtabmap.find( di->id());
 			if (ti != m_idsymtabmap.end())
 			{
 				di->setSymtabref( ti->second);
 			}
-			hspt.patternar[ didx] = expr;
-			hspt.idar[ didx] = didx+1;
-			if (di->editdist())
+			if (isGazetteerDef[ didx] || isUnreferenced[ didx]) continue;
+
+			if (si->editdist())
 			{
-				hspt.flagar[ didx] = options | HS_FLAG_SOM_LEFTMOST;
-				hspt.extar[ didx] = createPatternExprExtFlags( di->editdist());
+				hspt_editdist.patternar[ edidx] = hspt_editdist.exprpool.c_str() + exprposar[ didx];
+				hspt_editdist.idar[ edidx] = didx+1;
+				hspt_editdist.flagar[ edidx] = options | HS_FLAG_SOM_LEFTMOST | (isCaseless[ didx] ? HS_FLAG_CASELESS : 0);
+				hspt_editdist.extar[ edidx] = createPatternExprExtFlags( si->editdist(), si->hamming());
+				++edidx;
 			}
-			else if (m_hasEditDist)
+			else if (si->combination())
 			{
-				hspt.flagar[ didx] = options | HS_FLAG_SOM_LEFTMOST;
-				hspt.extar[ didx] = 0;
+				//... a combination is not scanned, it is evaluated on the matches of its operands
+				continue;
 			}
 			else
 			{
-				hspt.flagar[ didx] = options | HS_FLAG_UTF8 | HS_FLAG_SOM_LEFTMOST;
-				hspt.extar[ didx] = 0;
+				const char* expr = m_exprpool.c_str() + si->exprpos();
+				std::pair<ExpressionMap::iterator,bool> ins = exprmap.insert( ExpressionMap::value_type( std::string( expr, si->exprsize()), std::pair<std::size_t,std::size_t>( didx, didx)));
+				if (!ins.second)
+				{
+					std::pair<std::size_t,std::size_t>& chain = ins.first->second;
+					m_duplicatear[ chain.second] = didx+1;
+					chain.second = didx;
+					di->setFixWidth( m_defar[ chain.first].fixwidth());
+					++nofDuplicates;
+					continue;
+				}
+				hspt.patternar[ hsidx] = expr;
+				hspt.idar[ hsidx] = didx+1;
+				hspt.flagar[ hsidx] = options | HS_FLAG_UTF8 | HS_FLAG_SOM_LEFTMOST | (isCaseless[ didx] ? HS_FLAG_CASELESS : 0);
+				hspt.extar[ hsidx] = 0;
+
+				//... start of match tracking is expensive, calculate the start from the end of match if the pattern matches only strings of a fixed size:
+				unsigned int fixwidth = getFixedMatchWidth( expr, hspt.flagar[ hsidx] & ~HS_FLAG_SOM_LEFTMOST);
+				if (fixwidth)
+				{
+					hspt.flagar[ hsidx] &= ~HS_FLAG_SOM_LEFTMOST;
+					di->setFixWidth( fixwidth);
+				}
+				++hsidx;
 			}
 		}
-		hspt.patternar[ m_defar.size()] = 0;
-		hspt.idar[ m_defar.size()] = 0;
-		hspt.flagar[ m_defar.size()] = 0;
-		hspt.extar[ m_defar.size()] = 0;
+		if (nofDuplicates == 0)
+		{
+			std::vector<uint32_t>().swap( m_duplicatear);
+		}
+		hspt.arsize = hsidx;
+		hspt.patternar[ hsidx] = 0;
+		hspt.idar[ hsidx] = 0;
+		hspt.flagar[ hsidx] = 0;
+		hspt.extar[ hsidx] = 0;
+		hspt_editdist.patternar[ edidx] = 0;
+		hspt_editdist.idar[ edidx] = 0;
+		hspt_editdist.flagar[ edidx] = 0;
+		hspt_editdist.extar[ edidx] = 0;
+	}
+
+	/// \brief Get the size of all matches of an expression, if it is fixed
+	/// \return the size of all matches in bytes, 0 if the size of a match is variable, out of range or the expression is invalid
+	static unsigned int getFixedMatchWidth( const char* expr, unsigned int flags)
+	{
+		hs_expr_info_t* info = 0;
+		hs_compile_error_t* compile_err = 0;
+		if (hs_expression_info( expr, flags, &info, &compile_err) != HS_SUCCESS)
+		{
+			//... error is reported later when building the automaton
+			if (compile_err) hs_free_compile_error( compile_err);
+			return 0;
+		}
+		unsigned int rt = 0;
+		if (info->min_width == info->max_width && info->max_width <= std::numeric_limits<uint8_t>::max())
+		{
+			rt = info->max_width;
+		}
+		std::free( info);
+		return rt;
 	}
 
 	bool matchSubExpression( uint32_t subexpref, const char* src, unsigned_long_long& from, unsigned_long_long& to) const
@@ -417,13 +1718,106 @@ public:
 		}
 	}
 
-	///< Check, if there exists a pattern with edit distance match
+	///< Check, if there exists a pattern with edit distance match, scanned in the source mapped to a one byte character set
 	bool hasEditDist() const
 	{
 		return m_hasEditDist;
 	}
 
+	///< Check, if there exists a lexem defined as logical combination of other lexems
+	bool hasCombination() const
+	{
+		return m_hasCombination;
+	}
+
+	///< Get the table of lexems defined as logical combination of other lexems
+	const CombinationTable& combinations() const
+	{
+		return m_combinations;
+	}
+
+	///< Get the table of plain string lexems not matched by hyperscan
+	const GazetteerTable& gazetteer() const
+	{
+		return m_gazetteer;
+	}
+
 private:
+	/// \brief Mark the lexems that can be left out because they are not referenced and they can neither influence the ordinal positions nor supersede other lexems reported
+	/// \param[out] isUnreferenced flag for every lexem, set if the lexem can be left out, parallel to m_defar
+	/// \param[in] isOperand flag for every lexem, set if the lexem is referenced in a combination, parallel to m_defar
+	void markUnreferencedLexems( std::vector<bool>& isUnreferenced, const std::vector<bool>& isOperand) const
+	{
+		std::vector<bool> isKept( m_defar.size(), false);
+		unsigned int minKeptLevel = std::numeric_limits<unsigned int>::max();
+		std::size_t didx = 0;
+
+		//... a lexem bound to the predecessor or successor between two lexems with unique position prevents the second from being dropped, so these lexems have to be kept if there are lexems with unique position
+		bool hasUniquePosBind = false;
+		for (; didx < m_defar.size(); ++didx)
+		{
+			if (m_defar[ didx].posbind() == analyzer::BindUnique) hasUniquePosBind = true;
+		}
+		for (didx=0; didx < m_defar.size(); ++didx)
+		{
+			const PatternDef& def = m_defar[ didx];
+			if (m_srcar[ didx].combination() || isOperand[ didx] || hasUniquePosBind
+			||  def.posbind() == analyzer::BindContent || def.posbind() == analyzer::BindUnique
+			||  m_referencedIdSet.find( def.id()) != m_referencedIdSet.end()
+			||  m_idsymtabmap.find( def.id()) != m_idsymtabmap.end())
+			{
+				isKept[ didx] = true;
+				if (def.level() < minKeptLevel) minKeptLevel = def.level();
+			}
+		}
+		for (didx=0; didx < m_defar.size(); ++didx)
+		{
+			//... a lexem with a level higher than a lexem kept may supersede it, so it has to be kept too
+			if (!isKept[ didx] && m_defar[ didx].level() <= minKeptLevel)
+			{
+				isUnreferenced[ didx] = true;
+			}
+		}
+	}
+
+	/// \brief Compile the expressions of all lexems defined as logical combination into programs evaluated on the matches of the lexems combined
+	/// \param[out] isOperand flag for every lexem, set if the lexem is referenced in a combination, parallel to m_defar
+	/// \return true, if there exist any combinations
+	bool compileCombinations( std::vector<bool>& isOperand)
+	{
+		CombinationTable::IdIndexMap idmap;
+		std::size_t didx = 0;
+		bool rt = false;
+		for (; didx < m_srcar.size(); ++didx)
+		{
+			if (m_srcar[ didx].combination())
+			{
+				rt = true;
+			}
+			else
+			{
+				idmap[ m_defar[ didx].id()].push_back( didx);
+			}
+		}
+		if (!rt) return false;
+
+		for (didx=0; didx < m_srcar.size(); ++didx)
+		{
+			if (!m_srcar[ didx].combination()) continue;
+			m_combinations.define( didx+1, expression( didx), m_srcar[ didx].combinationSpan(), idmap, m_defar.size(), isOperand);
+		}
+		for (didx=0; didx < m_srcar.size(); ++didx)
+		{
+			//... operands are evaluated in the order of the matches reported by the scan of the exact lexems
+			if (isOperand[ didx] && m_srcar[ didx].editdist())
+			{
+				throw strus::runtime_error(_TXT("lexem %u with edit distance can not be used in a combination"), m_defar[ didx].id());
+			}
+		}
+		m_combinations.releaseSources();
+		return true;
+	}
+
 	uint8_t createSymbolTable()
 	{
 		if (m_symtabmap.size() >= std::numeric_limits<uint8_t>::max())
@@ -440,12 +1834,14 @@ private:
 
 		std::size_t index;
 		unsigned int editdist;
+		bool hamming;
 		bool usewchar;
 		enum {MaxSubexpressionIndex=99};
 
-		SubExpressionDef( const std::string& expression, std::size_t index_, unsigned int editdist_, bool usewchar_)
-			:index(index_),editdist(editdist_),usewchar(usewchar_)
+		SubExpressionDef( const std::string& expression, std::size_t index_, unsigned int editdist_, bool hamming_, bool caseless_, bool usewchar_)
+			:index(index_),editdist(editdist_),hamming(hamming_),usewchar(usewchar_)
 		{
+			int cflags = REG_EXTENDED | REG_APPROX_MATCHER | (caseless_ ? REG_ICASE : 0);
 			if (index > MaxSubexpressionIndex+1)
 			{
 				throw strus::runtime_error(_TXT("error in sub expression selection index out of range"));
@@ -455,11 +1851,11 @@ private:
 			{
 				WCharString wsrc( expression.c_str(), expression.size());
 				const wchar_t* wexpr = wsrc.str();
-				errcode = tre_regwcomp( &regex, wexpr, REG_EXTENDED | REG_APPROX_MATCHER);
+				errcode = tre_regwcomp( &regex, wexpr, cflags);
 			}
 			else
 			{
-				errcode = tre_regcomp( &regex, expression.c_str(), REG_EXTENDED | REG_APPROX_MATCHER);
+				errcode = tre_regcomp( &regex, expression.c_str(), cflags);
 			}
 			if (errcode)
 			{
@@ -507,18 +1903,36 @@ private:
 		}
 		
 private:
-		bool approx_match_utf8( const char* src, unsigned_long_long& from, unsigned_long_long& to, int& cost) const
+		regaparams_t approx_params() const
 		{
-			const char* start = src + from;
 			regaparams_t params;
 			params.cost_ins = 1;
 			params.cost_del = 1;
 			params.cost_subst = 1;
-			params.max_cost = editdist + 3;
-			params.max_del = editdist + 3;
-			params.max_ins = editdist + 3;
-			params.max_subst = editdist + 3;
-			params.max_err = editdist + 3;
+			if (hamming)
+			{
+				//... substitution only verifier
+				params.max_cost = editdist;
+				params.max_del = 0;
+				params.max_ins = 0;
+				params.max_subst = editdist;
+				params.max_err = editdist;
+			}
+			else
+			{
+				params.max_cost = editdist + 3;
+				params.max_del = editdist + 3;
+				params.max_ins = editdist + 3;
+				params.max_subst = editdist + 3;
+				params.max_err = editdist + 3;
+			}
+			return params;
+		}
+
+		bool approx_match_utf8( const char* src, unsigned_long_long& from, unsigned_long_long& to, int& cost) const
+		{
+			const char* start = src + from;
+			regaparams_t params = approx_params();
 
 			regmatch_t pmatch[ MaxSubexpressionIndex+1];
 			regamatch_t amatch;
@@ -547,16 +1961,7 @@ private:
 		{
 			WCharString wsrc( src + from, to - from + editdist * sizeof(wchar_t));
 			const wchar_t* wstart = wsrc.str();
-
-			regaparams_t params;
-			params.cost_ins = 1;
-			params.cost_del = 1;
-			params.cost_subst = 1;
-			params.max_cost = editdist + 3;
-			params.max_del = editdist + 3;
-			params.max_ins = editdist + 3;
-			params.max_subst = editdist + 3;
-			params.max_err = editdist + 3;
+			regaparams_t params = approx_params();
 
 			regmatch_t pmatch[ MaxSubexpressionIndex+1];
 			regamatch_t amatch;
@@ -590,23 +1995,40 @@ private:
 
 	static bool isDigit( char ch)	{return ch >= '0' && ch <= '9';}
 
-	unsigned int extractEditDistFromExpression( std::string& expr)
+	/// \brief Extract the distance suffix of an expression, "~N" for edit distance (Levenshtein) or "~HN" (resp. "~hN") for Hamming distance
+	/// \remark Throws on a suffix "~H" without distance
+	/// \param[in,out] expr expression, the suffix is cut away if found
+	/// \param[out] hamming true if the distance is a Hamming distance
+	/// \return the distance or 0 if not specified
+	unsigned int extractEditDistFromExpression( std::string& expr, bool& hamming)
 	{
 		const char* si = expr.c_str();
 		char const* se = si + expr.size();
+		hamming = false;
 		if (si == se) return 0;
 		unsigned int dcnt = 0;
 		for (--se; se >= si && (unsigned char)*se <= 32; --se){}
 		for (; se >= si && isDigit( *se); --se,++dcnt){}
+		if (dcnt == 0 && se > si && (*se|32) == 'h' && *(se-1) == '~')
+		{
+			throw strus::runtime_error(_TXT("missing distance in suffix '~H<N>' of expression '%s'"), expr.c_str());
+		}
 		if (dcnt > 0)
 		{
 			const char* ediststr = se+1;
+			bool isHamming = false;
+			if (se > si && (*se|32) == 'h' && *(se-1) == '~')
+			{
+				isHamming = true;
+				--se;
+			}
 			for (; se >= si && (unsigned char)*se <= 32; --se){}
 			if (se >= si && *se == '~')
 			{
 				unsigned int rt = atoi( ediststr);
 				for (; se > si && (unsigned char)*(se-1) <= 32; --se){}
 				expr.resize( se-si);
+				hamming = isHamming;
 				return rt;
 			}
 		}
@@ -615,14 +2037,23 @@ private:
 
 private:
 	ErrorBufferInterface* m_errorhnd;
-	std::vector<PatternDef> m_defar;			///< list of expressions and their attributes defined for the automaton to recognize
+	std::vector<PatternDef> m_defar;			///< list of lexems defined with the attributes needed at match time
+	std::vector<PatternSource> m_srcar;			///< list of lexems defined with the attributes needed only for building the automaton, parallel to m_defar
+	std::string m_exprpool;					///< string pool with all regular expressions defined, '\0' terminated, referenced by m_srcar
 	std::vector<Reference<SymbolTable> > m_symtabmap;	///< map PatternDef::symtabref -> symbol table
 	std::vector<uint32_t> m_symidmap;			///< map symbol table id -> symbol identifier id given by defineSymbol
 	typedef std::map<uint32_t,uint8_t> IdSymTabMap;
 	IdSymTabMap m_idsymtabmap;				///< map pattern id -> index in m_symtabmap == PatternDef::symtabref
+	std::set<uint32_t> m_referencedIdSet;			///< set of lexem identifiers referenced by the consumer of the lexems
+	bool m_hasReferencedIdSet;				///< true, if the referenced lexems have been declared, all lexems are reported else
 	typedef Reference<SubExpressionDef> SubExpressionReference;
 	std::vector<SubExpressionReference> m_subexprmap;	///< single regular expression patterns for extracting subexpressions if they are referenced.
-	bool m_hasEditDist;					///< true if the automaton has edit dist and had to be mapped down to a one byte character set serving as hash
+	GazetteerTable m_gazetteer;				///< plain string lexems matched with a trie instead of hyperscan
+	CombinationTable m_combinations;			///< lexems defined as logical combination of other lexems
+	std::vector<uint32_t> m_duplicatear;			///< index of the next pattern with the same regular expression, parallel to m_defar, empty if there are no duplicates
+	bool m_hasEditDist;					///< true if there are lexems with edit dist, scanned with an own automaton in the source mapped down to a one byte character set serving as hash
+	bool m_hasCombination;					///< true if there are lexems defined as logical combination of other lexems
+	bool m_released;					///< true if the data only needed for building the automaton has been freed
 };
 
 
@@ -630,12 +2061,22 @@ struct TermMatchData
 {
 	PatternTable patternTable;
 	hs_database_t* patterndb;
+	hs_database_t* asciidb;		///< database built from the same expressions without the Unicode flags, used instead of patterndb for sources with ASCII characters only, 0 if not available
+	hs_database_t* editdistdb;	///< database for lexems with edit distance scanning the source mapped down to a one byte character set
+	hs_database_t* streamdb;	///< database built from the same expressions as patterndb for scanning a text fed in chunks, 0 if not compiled with the option STREAM
+	std::size_t maxLexemWidth;	///< upper bound for the size of a match in bytes of the scanned text or 0 if unbounded
+	unsigned int nofThreads;	///< number of threads used for scanning a single document, 0 or 1 for sequential scanning
+	bool casefold;			///< true, if the source is mapped to lower case before scanning it with automatons built from expressions mapped to lower case
+	bool stream;			///< true, if texts fed in chunks can be scanned (option STREAM)
 
 	explicit TermMatchData( ErrorBufferInterface* errorhnd_)
-		:patternTable( errorhnd_),patterndb(0){}
+		:patternTable( errorhnd_),patterndb(0),asciidb(0),editdistdb(0),streamdb(0),maxLexemWidth(0),nofThreads(0),casefold(false),stream(false){}
 	~TermMatchData()
 	{
 		if (patterndb) hs_free_database(patterndb);
+		if (asciidb) hs_free_database(asciidb);
+		if (editdistdb) hs_free_database(editdistdb);
+		if (streamdb) hs_free_database(streamdb);
 	}
 };
 
@@ -655,38 +2096,150 @@ struct MatchEvent
 		:id(o.id),level(o.level),posbind(o.posbind),origsize(o.origsize),origpos(o.origpos){}
 };
 
+/// \brief Match event as reported by hyperscan, without any postprocessing
+struct RawMatchEvent
+{
+	unsigned int patternIdx;
+	unsigned_long_long from;
+	unsigned_long_long to;
+
+	RawMatchEvent( unsigned int patternIdx_, unsigned_long_long from_, unsigned_long_long to_)
+		:patternIdx(patternIdx_),from(from_),to(to_){}
+	RawMatchEvent( const RawMatchEvent& o)
+		:patternIdx(o.patternIdx),from(o.from),to(o.to){}
+};
+
+/// \brief Scan of one chunk of a document in parallel chunked mode
+/// \remark The scanned region overlaps with the neighbour chunks by the maximum lexem width plus a context margin for assertions like '\b'. Only matches ending in the own region [ownstart,ownend) are collected, so that every match is reported by exactly one chunk.
+struct ChunkScan
+{
+	enum {ContextMargin=8};
+
+	const hs_database_t* patterndb;
+	hs_scratch_t* scratch;
+	const char* buf;
+	std::size_t scanstart;
+	std::size_t scanend;
+	std::size_t ownstart;
+	std::size_t ownend;
+	std::vector<RawMatchEvent> events;
+	hs_error_t err;
+	bool outOfMem;
+
+	ChunkScan()
+		:patterndb(0),scratch(0),buf(0),scanstart(0),scanend(0),ownstart(0),ownend(0),events(),err(HS_SUCCESS),outOfMem(false){}
+	ChunkScan( const ChunkScan& o)
+		:patterndb(o.patterndb),scratch(o.scratch),buf(o.buf)
+		,scanstart(o.scanstart),scanend(o.scanend),ownstart(o.ownstart),ownend(o.ownend)
+		,events(o.events),err(o.err),outOfMem(o.outOfMem){}
+
+	void init( const hs_database_t* patterndb_, hs_scratch_t* scratch_, const char* buf_, std::size_t buflen, std::size_t ownstart_, std::size_t ownend_, std::size_t overlap)
+	{
+		patterndb = patterndb_;
+		scratch = scratch_;
+		buf = buf_;
+		ownstart = ownstart_;
+		ownend = ownend_;
+		scanstart = (ownstart > overlap + ContextMargin) ? (ownstart - overlap - ContextMargin) : 0;
+		scanend = (ownend + ContextMargin < buflen) ? (ownend + ContextMargin) : buflen;
+		events.clear();
+		err = HS_SUCCESS;
+		outOfMem = false;
+	}
+
+	void run()
+	{
+		err = hs_scan( patterndb, buf + scanstart, scanend - scanstart, 0/*reserved*/, scratch, match_event_handler, this);
+	}
+
+	static int match_event_handler( unsigned int patternIdx, unsigned_long_long from, unsigned_long_long to, unsigned int, void *context)
+	{
+		ChunkScan* THIS = (ChunkScan*)context;
+		try
+		{
+			to += THIS->scanstart;
+			if (to >= THIS->ownstart && to < THIS->ownend)
+			{
+				THIS->events.push_back( RawMatchEvent( patternIdx, from + THIS->scanstart, to));
+			}
+			return 0;
+		}
+		catch (const std::bad_alloc&)
+		{
+			THIS->outOfMem = true;
+			return -1;
+		}
+	}
+
+	struct Runner
+	{
+		explicit Runner( ChunkScan* ref_)	:ref(ref_){}
+		void operator()()			{ref->run();}
+		ChunkScan* ref;
+	};
+};
+
 class PatternLexerContext
 	:public PatternLexerContextInterface
+	,public PatternLexerContextBatchInterface
+	,public PatternLexerContextLexemMaskInterface
+	,public PatternLexerContextStreamInterface
 {
 public:
+	/// \brief Size of the text kept for rematching subexpressions when scanning a text fed in chunks, bigger than the size of any lexem match and within the start of match horizon of the stream database
+	enum {StreamWindowSize=(1<<16)};
+
 	PatternLexerContext( const TermMatchData* data_, ErrorBufferInterface* errorhnd_)
-		:m_errorhnd(errorhnd_),m_data(data_),m_hs_scratch(0),m_src(0),m_matchEventAr(),m_charmap()
+		:m_errorhnd(errorhnd_),m_data(data_),m_hs_scratch(0),m_src(0),m_scansrc(0),m_srcpos(0),m_foldmap(),m_operandMatchAr(),m_combinationEndAr(),m_matchEventAr(),m_charmap(),m_pendingMatchAr(),m_pendingMatchIdx(0),m_editDistMatchAr(),m_chunkScratchAr(),m_chunkScanAr(),m_disabledar(),m_stream(0),m_streamOpen(false),m_window(),m_windowpos(0),m_streampos(0),m_streamState(),m_streamLexemAr()
 	{
-		hs_error_t err = hs_alloc_scratch( m_data->patterndb, &m_hs_scratch);
-		if (err != HS_SUCCESS)
+		m_hs_scratch = allocScratch();
+	}
+
+	/// \brief Allocate a scratch usable for all hyperscan databases
+	hs_scratch_t* allocScratch() const
+	{
+		hs_scratch_t* rt = 0;
+		if (m_data->patterndb && HS_SUCCESS != hs_alloc_scratch( m_data->patterndb, &rt))
+		{
+			if (rt) hs_free_scratch( rt);
+			throw std::bad_alloc();
+		}
+		if (m_data->asciidb && HS_SUCCESS != hs_alloc_scratch( m_data->asciidb, &rt))
+		{
+			if (rt) hs_free_scratch( rt);
+			throw std::bad_alloc();
+		}
+		if (m_data->editdistdb && HS_SUCCESS != hs_alloc_scratch( m_data->editdistdb, &rt))
+		{
+			if (rt) hs_free_scratch( rt);
+			throw std::bad_alloc();
+		}
+		if (m_data->streamdb && HS_SUCCESS != hs_alloc_scratch( m_data->streamdb, &rt))
 		{
+			if (rt) hs_free_scratch( rt);
 			throw std::bad_alloc();
 		}
+		return rt;
 	}
 
 	virtual ~PatternLexerContext()
 	{
-		hs_free_scratch( m_hs_scratch);
+		discardStream();
+		freeChunkScratches();
+		if (m_hs_scratch) hs_free_scratch( m_hs_scratch);
 	}
 
 	virtual void reset()
 	{
 		try
 		{
-			hs_scratch_t* new_scratch = 0;
-			hs_error_t err = hs_alloc_scratch( m_data->patterndb, &m_hs_scratch);
-			if (err != HS_SUCCESS)
-			{
-				throw std::bad_alloc();
-			}
-			hs_free_scratch( m_hs_scratch);
+			hs_scratch_t* new_scratch = allocScratch();
+			discardStream();
+			freeChunkScratches();
+			if (m_hs_scratch) hs_free_scratch( m_hs_scratch);
 			m_hs_scratch = new_scratch;
 			m_src = 0;
+			m_scansrc = 0;
 		}
 		CATCH_ERROR_MAP( _TXT("error calling hyperscan lexer reset: %s"), *m_errorhnd);
 	}
@@ -696,110 +2249,285 @@ public:
 		PatternLexerContext* THIS = (PatternLexerContext*)context;
 		try
 		{
-			if (THIS->m_data->patternTable.hasEditDist())
+			THIS->handleMatchEvent( patternIdx, from, to);
+			return 0;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("error calling hyperscan match event handler: %s"), *THIS->m_errorhnd, -1);
+	}
+
+	void handleMatchEvent( unsigned int patternIdx, unsigned_long_long from, unsigned_long_long to)
+	{
+		const PatternDef& patternDef = m_data->patternTable.patternDef( patternIdx);
+		if (patternDef.fixwidth())
+		{
+			//... pattern compiled without start of match tracking
+			from = to - patternDef.fixwidth();
+		}
+		unsigned int pidx = patternIdx;
+		for (; pidx && isDisabled( pidx); pidx = m_data->patternTable.nextDuplicate( pidx)){}
+		if (pidx)
+		{
+			flushPendingMatches( to);
+			for (; pidx; pidx = m_data->patternTable.nextDuplicate( pidx))
 			{
-				from = THIS->m_charmap.posar[ from];
-				to = THIS->m_charmap.posar[ to];
+				if (!isDisabled( pidx)) pushMatchEvent( pidx, from, to);
 			}
-			if (to - from >= std::numeric_limits<uint16_t>::max())
+		}
+		if (m_data->patternTable.hasCombination())
+		{
+			//... the state of the operands is also updated for disabled lexems, because they may be operands of combinations enabled
+			matchCombinations( patternIdx, from, to);
+		}
+	}
+
+	/// \brief Evaluate the lexems defined as logical combination referencing a lexem matched as operand
+	void matchCombinations( unsigned int patternIdx, unsigned_long_long from, unsigned_long_long to)
+	{
+		const CombinationTable& combinations = m_data->patternTable.combinations();
+		unsigned int pidx = patternIdx;
+		for (; pidx; pidx = m_data->patternTable.nextDuplicate( pidx))
+		{
+			unsigned int operand = combinations.operand( pidx);
+			if (!operand) continue;
+
+			//... only the match of an operand with the biggest start position is relevant, because all matches reported end before or at the current position
+			CombinationOperandMatch& om = m_operandMatchAr[ operand-1];
+			if (!om.matched || om.from < from)
 			{
-				throw strus::runtime_error( "size of matched term out of range");
+				om.from = from;
+				om.matched = true;
 			}
-			const PatternDef& patternDef = THIS->m_data->patternTable.patternDef( patternIdx);
-			if (patternDef.subexpref())
+			const std::vector<uint32_t>& triggers = combinations.triggers( operand-1);
+			std::vector<uint32_t>::const_iterator ti = triggers.begin(), te = triggers.end();
+			for (; ti != te; ++ti)
 			{
-				if (!THIS->m_data->patternTable.matchSubExpression( patternDef.subexpref(), THIS->m_src, from, to))
+				const CombinationTable::Combination& comb = combinations.combination( *ti);
+				//... a combination is reported only once at the end of operand matches ending at the same position
+				if (m_combinationEndAr[ *ti] == to+1 || isDisabled( comb.patternidx)) continue;
+				unsigned_long_long combfrom;
+				if (combinations.match( comb, &m_operandMatchAr[0], to, combfrom))
 				{
-					return 0;
+					m_combinationEndAr[ *ti] = to+1;
+					flushPendingMatches( to);
+					pushMatchEvent( comb.patternidx, combfrom, to);
 				}
 			}
-			unsigned int patternid = patternDef.id();
-			if (patternDef.symtabref())
+		}
+	}
+
+	static int editdist_match_event_handler( unsigned int patternIdx, unsigned_long_long from, unsigned_long_long to, unsigned int, void *context)
+	{
+		PatternLexerContext* THIS = (PatternLexerContext*)context;
+		try
+		{
+			if (THIS->isDisabled( patternIdx)) return 0;
+			THIS->m_editDistMatchAr.push_back( LexemMatch( patternIdx, THIS->m_charmap.posar[ from], THIS->m_charmap.posar[ to]));
+			return 0;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("error calling hyperscan match event handler: %s"), *THIS->m_errorhnd, -1);
+	}
+
+	void freeChunkScratches()
+	{
+		std::vector<hs_scratch_t*>::const_iterator si = m_chunkScratchAr.begin(), se = m_chunkScratchAr.end();
+		for (; si != se; ++si)
+		{
+			hs_free_scratch( *si);
+		}
+		m_chunkScratchAr.clear();
+	}
+
+	/// \brief Get the number of chunks to scan in parallel for a text of a given size
+	std::size_t nofScanChunks( std::size_t buflen) const
+	{
+		enum {MinChunkSize=(1<<16)};
+		if (m_data->nofThreads <= 1 || !m_data->maxLexemWidth) return 1;
+		std::size_t minChunkSize = m_data->maxLexemWidth * 4;
+		if (minChunkSize < (std::size_t)MinChunkSize) minChunkSize = MinChunkSize;
+		std::size_t rt = buflen / minChunkSize;
+		if (rt > m_data->nofThreads) rt = m_data->nofThreads;
+		return rt ? rt : 1;
+	}
+
+	/// \brief Scan a text split into overlapping chunks in parallel, the matches are fed in the same order as with a sequential scan into the match event handler
+	hs_error_t scanChunksParallel( const hs_database_t* patterndb, const char* buf, std::size_t buflen, std::size_t nofChunks)
+	{
+		while (m_chunkScratchAr.size() < nofChunks)
+		{
+			hs_scratch_t* scratch = 0;
+			if (hs_clone_scratch( m_hs_scratch, &scratch) != HS_SUCCESS)
+			{
+				throw std::bad_alloc();
+			}
+			m_chunkScratchAr.push_back( scratch);
+		}
+		m_chunkScanAr.resize( nofChunks);
+		std::size_t chunksize = buflen / nofChunks;
+		std::size_t ci = 0;
+		for (; ci < nofChunks; ++ci)
+		{
+			std::size_t ownstart = ci * chunksize;
+			std::size_t ownend = (ci+1 == nofChunks) ? (buflen+1) : ((ci+1) * chunksize);
+			m_chunkScanAr[ ci].init( patterndb, m_chunkScratchAr[ ci], buf, buflen, ownstart, ownend, m_data->maxLexemWidth);
+		}
+		{
+			utils::ThreadGroup threads;
+			for (ci=1; ci < nofChunks; ++ci)
+			{
+				threads.create_thread( ChunkScan::Runner( &m_chunkScanAr[ ci]));
+			}
+			m_chunkScanAr[ 0].run();
+			threads.join_all();
+		}
+		// Feed the matches of all chunks in ascending order into the match event handler:
+		for (ci=0; ci < nofChunks; ++ci)
+		{
+			const ChunkScan& chunk = m_chunkScanAr[ ci];
+			if (chunk.outOfMem) throw std::bad_alloc();
+			if (chunk.err != HS_SUCCESS) return chunk.err;
+			std::vector<RawMatchEvent>::const_iterator ei = chunk.events.begin(), ee = chunk.events.end();
+			for (; ei != ee; ++ei)
+			{
+				handleMatchEvent( ei->patternIdx, ei->from, ei->to);
+			}
+		}
+		for (ci=0; ci < nofChunks; ++ci)
+		{
+			m_chunkScanAr[ ci].events.clear();
+		}
+		return HS_SUCCESS;
+	}
+
+	///\brief Feed the gazetteer and edit distance matches ending before or at a position into the match event resolution
+	void flushPendingMatches( unsigned_long_long to)
+	{
+		for (; m_pendingMatchIdx < m_pendingMatchAr.size() && m_pendingMatchAr[ m_pendingMatchIdx].to <= to; ++m_pendingMatchIdx)
+		{
+			const LexemMatch& gm = m_pendingMatchAr[ m_pendingMatchIdx];
+			if (isDisabled( gm.patternidx)) continue;
+			pushMatchEvent( gm.patternidx, gm.from, gm.to);
+		}
+	}
+
+	void pushMatchEvent( unsigned int patternIdx, unsigned_long_long from, unsigned_long_long to)
+	{
+		const PatternDef& patternDef = m_data->patternTable.patternDef( patternIdx);
+		if (m_srcpos)
+		{
+			//... positions in a text fed in chunks are relative to the start of the text, the source is the window kept of it
+			if (from < m_srcpos)
+			{
+				throw strus::runtime_error( "size of matched term out of range");
+			}
+			from -= m_srcpos;
+			to -= m_srcpos;
+		}
+		if (patternDef.subexpref())
+		{
+			if (!m_data->patternTable.matchSubExpression( patternDef.subexpref(), m_scansrc, from, to))
 			{
-				unsigned int symid = THIS->m_data->patternTable.symbolId( patternDef.symtabref(), THIS->m_src + from, (uint32_t)(to-from));
-				if (symid) patternid = symid;
+				return;
 			}
-			MatchEvent matchEvent( patternDef.id(), patternDef.level(), patternDef.posbind(), (uint32_t)from, (uint32_t)(to-from));
-			if (THIS->m_matchEventAr.empty())
+		}
+		if (m_data->casefold)
+		{
+			//... map the positions in the folded source to the positions in the original source
+			from = m_foldmap.origpos( from);
+			to = m_foldmap.origpos( to);
+		}
+		if (to - from >= std::numeric_limits<uint16_t>::max())
+		{
+			throw strus::runtime_error( "size of matched term out of range");
+		}
+		unsigned int patternid = patternDef.id();
+		if (patternDef.symtabref())
+		{
+			unsigned int symid = m_data->patternTable.symbolId( patternDef.symtabref(), m_src + from, (uint32_t)(to-from));
+			if (symid) patternid = symid;
+		}
+		if (m_srcpos)
+		{
+			from += m_srcpos;
+			to += m_srcpos;
+		}
+		MatchEvent matchEvent( patternDef.id(), patternDef.level(), patternDef.posbind(), (uint32_t)from, (uint32_t)(to-from));
+		if (m_matchEventAr.empty())
+		{
+			m_matchEventAr.push_back( matchEvent);
+			if (patternid != patternDef.id())
 			{
-				THIS->m_matchEventAr.push_back( matchEvent);
-				if (patternid != patternDef.id())
-				{
-					THIS->m_matchEventAr.push_back( MatchEvent( patternid, patternDef.level(), patternDef.posbind(), (uint32_t)from, (uint32_t)(to-from)));
-				}
+				m_matchEventAr.push_back( MatchEvent( patternid, patternDef.level(), patternDef.posbind(), (uint32_t)from, (uint32_t)(to-from)));
 			}
-			else
+		}
+		else
+		{
+			// Handle superseeding of elements by elements with higher level:
+			std::size_t nofDeletes = 0;
+			uint32_t matchLastPos = matchEvent.origpos + matchEvent.origsize;
+			std::vector<MatchEvent>::reverse_iterator
+				mi = m_matchEventAr.rbegin(),
+				me = m_matchEventAr.rend();
+			for (; mi != me && mi->origpos >= matchEvent.origpos; ++mi)
 			{
-				// Handle superseeding of elements by elements with higher level:
-				std::size_t nofDeletes = 0;
-				uint32_t matchLastPos = matchEvent.origpos + matchEvent.origsize;
-				std::vector<MatchEvent>::reverse_iterator
-					mi = THIS->m_matchEventAr.rbegin(),
-					me = THIS->m_matchEventAr.rend();
-				for (; mi != me && mi->origpos >= matchEvent.origpos; ++mi)
+				if ((matchEvent.id == mi->id && mi->origpos == matchEvent.origpos && mi->level == matchEvent.level)
+				|| (mi->level < matchEvent.level && mi->origpos + mi->origsize <= matchLastPos))
 				{
-					if ((matchEvent.id == mi->id && mi->origpos == matchEvent.origpos && mi->level == matchEvent.level)
-					|| (mi->level < matchEvent.level && mi->origpos + mi->origsize <= matchLastPos))
+					// ... an old element is overwritten because it is completely covered by one element with a higher level already in the list
+					std::vector<MatchEvent>::iterator oi = mi.base()-1;
+					std::vector<MatchEvent>::iterator prev_oi = oi++;
+					for (; oi != m_matchEventAr.end(); prev_oi = oi++)
 					{
-						// ... an old element is overwritten because it is completely covered by one element with a higher level already in the list
-						std::vector<MatchEvent>::iterator oi = mi.base()-1;
-						std::vector<MatchEvent>::iterator prev_oi = oi++;
-						for (; oi != THIS->m_matchEventAr.end(); prev_oi = oi++)
-						{
-							*prev_oi = *oi;
-						}
-						++nofDeletes;
+						*prev_oi = *oi;
 					}
+					++nofDeletes;
 				}
-				THIS->m_matchEventAr.resize( THIS->m_matchEventAr.size()-nofDeletes);
-				if (!nofDeletes)
+			}
+			m_matchEventAr.resize( m_matchEventAr.size()-nofDeletes);
+			if (!nofDeletes)
+			{
+				// ... if we had delete then there cannot exist an element covering the
+				//     new element. Otherwise deletes would have happened before
+				mi = m_matchEventAr.rbegin();
+				me = m_matchEventAr.rend();
+				for (; mi != me && mi->origpos + mi->origsize >= matchLastPos; ++mi)
 				{
-					// ... if we had delete then there cannot exist an element covering the
-					//     new element. Otherwise deletes would have happened before
-					mi = THIS->m_matchEventAr.rbegin();
-					me = THIS->m_matchEventAr.rend();
-					for (; mi != me && mi->origpos + mi->origsize >= matchLastPos; ++mi)
+					if (mi->level > matchEvent.level && mi->origpos <= matchEvent.origpos)
 					{
-						if (mi->level > matchEvent.level && mi->origpos <= matchEvent.origpos)
-						{
-							// ... the new element is ignored because it is completely covered by one element with a higher level already in the list
-							return 0;
-						}
+						// ... the new element is ignored because it is completely covered by one element with a higher level already in the list
+						return;
 					}
 				}
-				// Insert the new element with ascending order of origpos
-				if (patternid == patternDef.id())
+			}
+			// Insert the new element with ascending order of origpos
+			if (patternid == patternDef.id())
+			{
+				m_matchEventAr.resize( m_matchEventAr.size() + 1);
+				mi = m_matchEventAr.rbegin();
+				me = m_matchEventAr.rend();
+				std::vector<MatchEvent>::reverse_iterator prev_mi = mi;
+				for (++mi; mi != me && mi->origpos > matchEvent.origpos; prev_mi=mi++)
 				{
-					THIS->m_matchEventAr.resize( THIS->m_matchEventAr.size() + 1);
-					mi = THIS->m_matchEventAr.rbegin();
-					me = THIS->m_matchEventAr.rend();
-					std::vector<MatchEvent>::reverse_iterator prev_mi = mi;
-					for (++mi; mi != me && mi->origpos > matchEvent.origpos; prev_mi=mi++)
-					{
-						*prev_mi = *mi;
-					}
-					--mi;
-					*mi = matchEvent;
+					*prev_mi = *mi;
 				}
-				else
+				--mi;
+				*mi = matchEvent;
+			}
+			else
+			{
+				m_matchEventAr.resize( m_matchEventAr.size() + 2);
+				mi = m_matchEventAr.rbegin();
+				me = m_matchEventAr.rend();
+				std::vector<MatchEvent>::reverse_iterator prev_mi = mi;
+				for (mi+=2; mi != me && mi->origpos > matchEvent.origpos; prev_mi=mi++)
 				{
-					THIS->m_matchEventAr.resize( THIS->m_matchEventAr.size() + 2);
-					mi = THIS->m_matchEventAr.rbegin();
-					me = THIS->m_matchEventAr.rend();
-					std::vector<MatchEvent>::reverse_iterator prev_mi = mi;
-					for (mi+=2; mi != me && mi->origpos > matchEvent.origpos; prev_mi=mi++)
-					{
-						*prev_mi = *mi;
-					}
-					--mi;
-					*mi = matchEvent;
-					--mi;
-					*mi = MatchEvent( patternid, patternDef.level(), patternDef.posbind(), (uint32_t)from, (uint32_t)(to-from));
+					*prev_mi = *mi;
 				}
+				--mi;
+				*mi = matchEvent;
+				--mi;
+				*mi = MatchEvent( patternid, patternDef.level(), patternDef.posbind(), (uint32_t)from, (uint32_t)(to-from));
 			}
-			return 0;
 		}
-		CATCH_ERROR_MAP_RETURN( _TXT("error calling hyperscan match event handler: %s"), *THIS->m_errorhnd, -1);
 	}
 
 	static const char* hsErrorName( int ec)
@@ -832,98 +2560,362 @@ public:
 		}
 	}
 
+	/// \brief Collect all match events of a text in m_matchEventAr
+	void scanMatchEvents( const char* src, std::size_t srclen)
+	{
+		unsigned int nofExpectedTokens = srclen / 4 + 10;
+		m_matchEventAr.reserve( nofExpectedTokens);
+		m_src = src;
+		if (srclen >= (std::size_t)std::numeric_limits<uint32_t>::max())
+		{
+			throw strus::runtime_error( "size of string to scan out of range");
+		}
+		// Map the source to lower case once instead of matching caseless, the positions of matches in the folded source are mapped back with the position map of the folding:
+		std::size_t scanlen = srclen;
+		if (m_data->casefold)
+		{
+			m_foldmap.init( src, srclen);
+			m_scansrc = m_foldmap.value.c_str();
+			scanlen = m_foldmap.value.size();
+			if (scanlen >= (std::size_t)std::numeric_limits<uint32_t>::max())
+			{
+				throw strus::runtime_error( "size of string to scan out of range");
+			}
+		}
+		else
+		{
+			m_scansrc = src;
+		}
+		// Collect the matches of the gazetteer and of the lexems with edit distance, they are merged in ascending order of their end position into the Hyperscan matches of the exact lexems:
+		m_pendingMatchAr.clear();
+		m_pendingMatchIdx = 0;
+		if (m_data->patternTable.hasCombination())
+		{
+			m_operandMatchAr.assign( m_data->patternTable.combinations().nofOperands(), CombinationOperandMatch());
+			m_combinationEndAr.assign( m_data->patternTable.combinations().size(), 0);
+		}
+		if (!m_data->patternTable.gazetteer().empty())
+		{
+			m_data->patternTable.gazetteer().scan( m_pendingMatchAr, m_scansrc, scanlen);
+		}
+		hs_error_t err = HS_SUCCESS;
+		if (m_data->editdistdb)
+		{
+			m_charmap.init( m_scansrc, scanlen);
+			m_editDistMatchAr.clear();
+			err = hs_scan( m_data->editdistdb, m_charmap.value.c_str(), m_charmap.value.size(), 0/*reserved*/, m_hs_scratch, editdist_match_event_handler, this);
+			if (!m_editDistMatchAr.empty())
+			{
+				m_pendingMatchAr.insert( m_pendingMatchAr.end(), m_editDistMatchAr.begin(), m_editDistMatchAr.end());
+				std::sort( m_pendingMatchAr.begin(), m_pendingMatchAr.end());
+				m_editDistMatchAr.clear();
+			}
+		}
+		// Collect all matches of the exact lexems calling the Hyperscan engine:
+		if (!m_data->patterndb || err != HS_SUCCESS)
+		{}
+		else
+		{
+			//... the automaton without Unicode support is faster and produces the same matches on a source with ASCII characters only
+			const hs_database_t* patterndb = (m_data->asciidb && isAsciiString( m_scansrc, scanlen)) ? m_data->asciidb : m_data->patterndb;
+			std::size_t nofChunks = nofScanChunks( scanlen);
+			if (nofChunks > 1)
+			{
+				err = scanChunksParallel( patterndb, m_scansrc, scanlen, nofChunks);
+			}
+			else
+			{
+				err = hs_scan( patterndb, m_scansrc, scanlen, 0/*reserved*/, m_hs_scratch, match_event_handler, this);
+			}
+		}
+		if (err == HS_SUCCESS)
+		{
+			flushPendingMatches( scanlen);
+		}
+		m_pendingMatchAr.clear();
+		m_src = 0;
+		m_scansrc = 0;
+		if (err != HS_SUCCESS)
+		{
+			char srcbuf[ 128];
+			if (srclen > sizeof(srcbuf)-1) srclen = sizeof(srcbuf)-1;
+			std::memcpy( srcbuf, src, srclen);
+			srcbuf[ srclen] = 0;
+			m_matchEventAr.clear();
+			throw strus::runtime_error(_TXT("error matching pattern (hyperscan error %s) on '%s'"), hsErrorName(err), srcbuf);
+		}
+	}
+
+	/// \brief State of building the result lexems from match events in ascending order of their position, kept between parts of a text fed in chunks
+	struct ResultLexemState
+	{
+		uint32_t ordpos;		///< ordinal position of the last lexem bound to content, 0 if there was none yet
+		uint32_t origpos;		///< position in the source of the last lexem bound to content
+		uint8_t lastposbind;		///< position binding of the last match event
+
+		ResultLexemState()
+			:ordpos(0),origpos(0),lastposbind((uint8_t)analyzer::BindContent){}
+		ResultLexemState( const ResultLexemState& o)
+			:ordpos(o.ordpos),origpos(o.origpos),lastposbind(o.lastposbind){}
+	};
+
+	/// \brief Build the result lexems from match events
+	/// \param[out] rt where to append the result lexems to, either a vector of analyzer::PatternLexem or a PatternLexemBatch
+	/// \param[in,out] state state of building the result lexems from the match events before
+	/// \param[in] mi start of the match events
+	/// \param[in] me end of the match events
+	/// \remark Lexems bound to their successor before the first lexem bound to content are appended to rt, they have to be dropped if there is no lexem bound to content at all (state.ordpos == 0 at the end)
+	template <class ResultArray>
+	static void buildResultLexems( ResultArray& rt, ResultLexemState& state, std::vector<MatchEvent>::const_iterator mi, std::vector<MatchEvent>::const_iterator me)
+	{
+		// Build the result term array, calculate ordinal positions of the result terms:
+		for (; mi != me && state.ordpos == 0; ++mi)
+		{
+			state.lastposbind = mi->posbind;
+			switch ((analyzer::PositionBind)mi->posbind)
+			{
+				case analyzer::BindUnique:
+				case analyzer::BindContent:
+					state.ordpos = 1;
+					state.origpos = mi->origpos;
+					rt.push_back( analyzer::PatternLexem( mi->id, 1, 0/*origseg*/, mi->origpos, mi->origsize));
+					break;
+				case analyzer::BindSuccessor:
+					rt.push_back( analyzer::PatternLexem( mi->id, 1, 0/*origseg*/, mi->origpos, mi->origsize));
+					break;
+				case analyzer::BindPredecessor:
+					break;
+			}
+		}
+		for (; mi != me; ++mi)
+		{
+			switch ((analyzer::PositionBind)mi->posbind)
+			{
+				case analyzer::BindUnique:
+					if (state.lastposbind == (uint8_t)analyzer::BindUnique) break;
+				case analyzer::BindContent:
+					if (mi->origpos > state.origpos)
+					{
+						state.origpos = mi->origpos;
+						++state.ordpos;
+					}
+					rt.push_back( analyzer::PatternLexem( mi->id, state.ordpos, 0/*origseg*/, mi->origpos, mi->origsize));
+					break;
+				case analyzer::BindSuccessor:
+					rt.push_back( analyzer::PatternLexem( mi->id, state.ordpos+1, 0/*origseg*/, mi->origpos, mi->origsize));
+					break;
+				case analyzer::BindPredecessor:
+					rt.push_back( analyzer::PatternLexem( mi->id, state.ordpos, 0/*origseg*/, mi->origpos, mi->origsize));
+					break;
+			}
+			state.lastposbind = mi->posbind;
+		}
+	}
+
+	/// \brief Build the result lexems from the collected match events of a complete text
+	/// \param[out] rt where to write the result lexems to, either a vector of analyzer::PatternLexem or a PatternLexemBatch
+	template <class ResultArray>
+	void buildResultLexems( ResultArray& rt) const
+	{
+		ResultLexemState state;
+		buildResultLexems( rt, state, m_matchEventAr.begin(), m_matchEventAr.end());
+		if (state.ordpos == 0)
+		{
+			rt.clear();
+		}
+	}
+
 	virtual std::vector<analyzer::PatternLexem> match( const char* src, std::size_t srclen)
 	{
 		try
 		{
 			std::vector<analyzer::PatternLexem> rt;
-			unsigned int nofExpectedTokens = srclen / 4 + 10;
-			m_matchEventAr.reserve( nofExpectedTokens);
-			m_src = src;
-			if (srclen >= (std::size_t)std::numeric_limits<uint32_t>::max())
+			scanMatchEvents( src, srclen);
+			rt.reserve( m_matchEventAr.size());
+			buildResultLexems( rt);
+			m_matchEventAr.clear();
+			return rt;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("failed to run pattern matching terms with regular expressions: %s"), *m_errorhnd, std::vector<analyzer::PatternLexem>());
+	}
+
+	virtual void matchBatch( PatternLexemBatch& res, const char* src, std::size_t srclen)
+	{
+		try
+		{
+			res.clear();
+			scanMatchEvents( src, srclen);
+			res.reserve( m_matchEventAr.size());
+			buildResultLexems( res);
+			m_matchEventAr.clear();
+		}
+		CATCH_ERROR_MAP( _TXT("failed to run pattern matching terms with regular expressions: %s"), *m_errorhnd);
+	}
+
+	virtual void open()
+	{
+		try
+		{
+			if (!m_data->stream)
+			{
+				throw strus::runtime_error(_TXT("lexer not compiled with option STREAM"));
+			}
+			discardStream();
+			if (m_data->streamdb)
+			{
+				hs_error_t err = hs_open_stream( m_data->streamdb, 0/*flags*/, &m_stream);
+				if (err != HS_SUCCESS)
+				{
+					m_stream = 0;
+					throw strus::runtime_error(_TXT("error opening stream (hyperscan error %s)"), hsErrorName(err));
+				}
+			}
+			m_streamOpen = true;
+			if (m_data->patternTable.hasCombination())
+			{
+				m_operandMatchAr.assign( m_data->patternTable.combinations().nofOperands(), CombinationOperandMatch());
+				m_combinationEndAr.assign( m_data->patternTable.combinations().size(), 0);
+			}
+		}
+		CATCH_ERROR_MAP( _TXT("failed to open a text fed in chunks for matching terms with regular expressions: %s"), *m_errorhnd);
+	}
+
+	virtual void feed( std::vector<analyzer::PatternLexem>& res, const char* chunk, std::size_t chunksize)
+	{
+		try
+		{
+			if (!m_streamOpen)
+			{
+				throw strus::runtime_error(_TXT("called feed without calling open"));
+			}
+			if (chunksize >= (std::size_t)std::numeric_limits<uint32_t>::max() - m_streampos)
 			{
 				throw strus::runtime_error( "size of string to scan out of range");
 			}
-			// Collect all matches calling the Hyperscan engine:
-			hs_error_t err;
-			if (m_data->patternTable.hasEditDist())
+			// Keep the last part of the text for rematching subexpressions and looking up symbols, a match reported is shorter than StreamWindowSize:
+			if (m_window.size() > (std::size_t)StreamWindowSize)
 			{
-				m_charmap.init( src, srclen);
-				err = hs_scan( m_data->patterndb, m_charmap.value.c_str(), m_charmap.value.size(), 0/*reserved*/, m_hs_scratch, match_event_handler, this);
+				std::size_t nofDropped = m_window.size() - StreamWindowSize;
+				m_window.erase( 0, nofDropped);
+				m_windowpos += nofDropped;
 			}
-			else
+			std::size_t chunkpos = m_window.size();
+			m_window.append( chunk, chunksize);
+			if (m_stream)
 			{
-				err = hs_scan( m_data->patterndb, src, srclen, 0/*reserved*/, m_hs_scratch, match_event_handler, this);
+				scanStream( m_window.c_str() + chunkpos, chunksize);
 			}
-			m_src = 0;
-			if (err != HS_SUCCESS)
+			m_streampos += chunksize;
+
+			// Match events starting before the window of positions of any match still to come can not be superseded anymore:
+			unsigned_long_long cutoff = (m_streampos > (unsigned_long_long)StreamWindowSize) ? (m_streampos - StreamWindowSize) : 0;
+			std::vector<MatchEvent>::iterator mi = m_matchEventAr.begin(), me = m_matchEventAr.end();
+			for (; mi != me && mi->origpos < cutoff; ++mi){}
+			buildResultLexems( m_streamLexemAr, m_streamState, m_matchEventAr.begin(), mi);
+			m_matchEventAr.erase( m_matchEventAr.begin(), mi);
+			if (m_streamState.ordpos)
 			{
-				char srcbuf[ 128];
-				if (srclen > sizeof(srcbuf)-1) srclen = sizeof(srcbuf)-1;
-				std::memcpy( srcbuf, src, srclen);
-				srcbuf[ srclen] = 0;
-				m_matchEventAr.clear();
-				throw strus::runtime_error(_TXT("error matching pattern (hyperscan error %s) on '%s'"), hsErrorName(err), srcbuf);
+				//... lexems are held back until the first lexem bound to content has been seen, because they are dropped if there is none
+				res.insert( res.end(), m_streamLexemAr.begin(), m_streamLexemAr.end());
+				m_streamLexemAr.clear();
 			}
-			rt.reserve( m_matchEventAr.size());
+		}
+		CATCH_ERROR_MAP( _TXT("failed to match terms with regular expressions in a chunk of a text: %s"), *m_errorhnd);
+	}
 
-			// Build the result term array, calculate ordinal positions of the result terms:
-			std::vector<MatchEvent>::const_iterator
-				mi = m_matchEventAr.begin(), me = m_matchEventAr.end();
-			uint32_t ordpos = 0;
-			uint32_t origpos = 0;
-			uint8_t lastposbind = (uint8_t)analyzer::BindContent;
-			for (; mi != me; ++mi)
+	virtual void close( std::vector<analyzer::PatternLexem>& res)
+	{
+		try
+		{
+			if (!m_streamOpen)
+			{
+				throw strus::runtime_error(_TXT("called close without calling open"));
+			}
+			if (m_stream)
 			{
-				lastposbind = mi->posbind;
-				switch ((analyzer::PositionBind)mi->posbind)
+				//... matches at the end of the text (e.g. expressions with '$') are reported when closing the stream
+				m_src = m_scansrc = m_window.c_str();
+				m_srcpos = m_windowpos;
+				hs_error_t err = hs_close_stream( m_stream, m_hs_scratch, match_event_handler, this);
+				m_stream = 0;
+				m_src = m_scansrc = 0;
+				m_srcpos = 0;
+				if (err != HS_SUCCESS)
 				{
-					case analyzer::BindUnique:
-					case analyzer::BindContent:
-						ordpos = 1;
-						origpos = mi->origpos;
-						rt.push_back( analyzer::PatternLexem( mi->id, 1, 0/*origseg*/, mi->origpos, mi->origsize));
-						++mi;
-						goto EXITLOOP;
-					case analyzer::BindSuccessor:
-						rt.push_back( analyzer::PatternLexem( mi->id, 1, 0/*origseg*/, mi->origpos, mi->origsize));
-						break;
-					case analyzer::BindPredecessor:
-						break;
+					throw strus::runtime_error(_TXT("error matching pattern (hyperscan error %s) at the end of a text fed in chunks"), hsErrorName(err));
 				}
 			}
-			EXITLOOP:
-			if (ordpos == 0)
+			buildResultLexems( m_streamLexemAr, m_streamState, m_matchEventAr.begin(), m_matchEventAr.end());
+			if (m_streamState.ordpos)
 			{
-				rt.clear();
+				res.insert( res.end(), m_streamLexemAr.begin(), m_streamLexemAr.end());
 			}
-			for (; mi != me; ++mi)
+			discardStream();
+		}
+		CATCH_ERROR_MAP( _TXT("failed to close a text fed in chunks for matching terms with regular expressions: %s"), *m_errorhnd);
+	}
+
+	virtual void setLexemMask( const std::vector<unsigned int>& enabledIds)
+	{
+		try
+		{
+			std::set<unsigned int> idset( enabledIds.begin(), enabledIds.end());
+			const PatternTable& patternTable = m_data->patternTable;
+			m_disabledar.assign( patternTable.size(), true);
+			std::size_t pi = 0, pe = patternTable.size();
+			for (; pi != pe; ++pi)
 			{
-				switch ((analyzer::PositionBind)mi->posbind)
+				if (idset.find( patternTable.patternDef( pi+1).id()) != idset.end())
 				{
-					case analyzer::BindUnique:
-						if (lastposbind == (uint8_t)analyzer::BindUnique) break;
-					case analyzer::BindContent:
-						if (mi->origpos > origpos)
-						{
-							origpos = mi->origpos;
-							++ordpos;
-						}
-						rt.push_back( analyzer::PatternLexem( mi->id, ordpos, 0/*origseg*/, mi->origpos, mi->origsize));
-						break;
-					case analyzer::BindSuccessor:
-						rt.push_back( analyzer::PatternLexem( mi->id, ordpos+1, 0/*origseg*/, mi->origpos, mi->origsize));
-						break;
-					case analyzer::BindPredecessor:
-						rt.push_back( analyzer::PatternLexem( mi->id, ordpos, 0/*origseg*/, mi->origpos, mi->origsize));
-						break;
+					m_disabledar[ pi] = false;
 				}
-				lastposbind = mi->posbind;
 			}
-			m_matchEventAr.clear();
-			return rt;
 		}
-		CATCH_ERROR_MAP_RETURN( _TXT("failed to run pattern matching terms with regular expressions: %s"), *m_errorhnd, std::vector<analyzer::PatternLexem>());
+		CATCH_ERROR_MAP( _TXT("failed to set the lexems enabled in a lexer context: %s"), *m_errorhnd);
+	}
+
+	virtual void clearLexemMask()
+	{
+		std::vector<bool>().swap( m_disabledar);
+	}
+
+private:
+	bool isDisabled( unsigned int patternIdx) const
+	{
+		return !m_disabledar.empty() && m_disabledar[ patternIdx-1];
+	}
+
+	/// \brief Scan the next chunk of a text fed in chunks, the chunk is the end of the window kept of the text
+	void scanStream( const char* chunk, std::size_t chunksize)
+	{
+		m_src = m_scansrc = m_window.c_str();
+		m_srcpos = m_windowpos;
+		hs_error_t err = hs_scan_stream( m_stream, chunk, chunksize, 0/*reserved*/, m_hs_scratch, match_event_handler, this);
+		m_src = m_scansrc = 0;
+		m_srcpos = 0;
+		if (err != HS_SUCCESS)
+		{
+			discardStream();
+			throw strus::runtime_error(_TXT("error matching pattern (hyperscan error %s) in a chunk of a text"), hsErrorName(err));
+		}
+	}
+
+	/// \brief Discard the state of a text fed in chunks
+	void discardStream()
+	{
+		if (m_stream)
+		{
+			//... no match events are reported without scratch
+			hs_close_stream( m_stream, 0, 0, 0);
+			m_stream = 0;
+		}
+		m_streamOpen = false;
+		m_window.clear();
+		m_windowpos = 0;
+		m_streampos = 0;
+		m_streamState = ResultLexemState();
+		m_streamLexemAr.clear();
+		m_matchEventAr.clear();
 	}
 
 private:
@@ -931,16 +2923,36 @@ private:
 	const TermMatchData* m_data;
 	hs_scratch_t* m_hs_scratch;
 	const char* m_src;
+	const char* m_scansrc;				///< source scanned, the source mapped to lower case if case folding is enabled, else m_src
+	unsigned_long_long m_srcpos;			///< position of m_src in a text fed in chunks, the match positions reported are relative to the start of the text
+	FoldCaseMap m_foldmap;				///< source mapped to lower case with the map of its positions to the positions in the original source
+	std::vector<CombinationOperandMatch> m_operandMatchAr;	///< match state of every operand of lexems defined as logical combination
+	std::vector<unsigned_long_long> m_combinationEndAr;	///< end + 1 of the last match reported for every lexem defined as logical combination, 0 if none
 	std::vector<MatchEvent> m_matchEventAr;
 	OneByteCharMap m_charmap;
+	std::vector<LexemMatch> m_pendingMatchAr;
+	std::size_t m_pendingMatchIdx;
+	std::vector<LexemMatch> m_editDistMatchAr;
+	std::vector<hs_scratch_t*> m_chunkScratchAr;
+	std::vector<ChunkScan> m_chunkScanAr;
+	std::vector<bool> m_disabledar;			///< flag for every pattern index - 1, set if the lexem is disabled in this context, empty if all lexems are enabled
+	hs_stream_t* m_stream;				///< hyperscan stream of a text fed in chunks
+	bool m_streamOpen;				///< true, if a text fed in chunks has been opened
+	std::string m_window;				///< last part of a text fed in chunks, kept for rematching subexpressions and looking up symbols
+	unsigned_long_long m_windowpos;			///< position of the start of m_window in the text fed in chunks
+	unsigned_long_long m_streampos;			///< number of bytes of the text fed in chunks so far
+	ResultLexemState m_streamState;			///< state of building the result lexems of a text fed in chunks
+	std::vector<analyzer::PatternLexem> m_streamLexemAr;	///< result lexems of a text fed in chunks held back until the first lexem bound to content
 };
 
 class PatternLexerInstance
 	:public PatternLexerInstanceInterface
+	,public PatternLexerInstanceCombinationInterface
+	,public PatternLexerInstanceVocabularyInterface
 {
 public:
 	explicit PatternLexerInstance( ErrorBufferInterface* errorhnd_)
-		:m_errorhnd(errorhnd_),m_data(errorhnd_),m_state(DefinitionPhase),m_flags(0),m_idnamemap(),m_idnamestrings()
+		:m_errorhnd(errorhnd_),m_data(errorhnd_),m_state(DefinitionPhase),m_flags(0),m_gazetteer(false),m_idnamemap(),m_idnamestrings()
 	{}
 
 	virtual ~PatternLexerInstance(){}
@@ -982,6 +2994,48 @@ public:
 		CATCH_ERROR_MAP( _TXT("failed to define term match regular expression pattern: %s"), *m_errorhnd);
 	}
 
+	virtual void defineLexemCombination(
+			unsigned int id,
+			const std::string& expression,
+			unsigned int span,
+			unsigned int level,
+			analyzer::PositionBind posbind)
+	{
+		try
+		{
+			if (m_state != DefinitionPhase)
+			{
+				throw strus::runtime_error(_TXT("called define pattern after calling 'compile'"));
+			}
+			m_data.patternTable.defineCombination( id, expression, span, level, posbind);
+		}
+		CATCH_ERROR_MAP( _TXT("failed to define term match lexem combination: %s"), *m_errorhnd);
+	}
+
+	virtual std::vector<unsigned int> getVocabulary() const
+	{
+		try
+		{
+			std::vector<unsigned int> rt;
+			m_data.patternTable.getVocabulary( rt);
+			return rt;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("failed to get the lexems defined: %s"), *m_errorhnd, std::vector<unsigned int>());
+	}
+
+	virtual void defineReferencedLexems( const std::vector<unsigned int>& ids)
+	{
+		try
+		{
+			if (m_state != DefinitionPhase)
+			{
+				throw strus::runtime_error(_TXT("called define referenced lexems after calling 'compile'"));
+			}
+			m_data.patternTable.defineReferencedLexems( ids);
+		}
+		CATCH_ERROR_MAP( _TXT("failed to define the lexems referenced: %s"), *m_errorhnd);
+	}
+
 	virtual void defineSymbol( unsigned int symbolid, unsigned int patternid, const std::string& name)
 	{
 		try
@@ -1005,7 +3059,7 @@ public:
 		CATCH_ERROR_MAP_RETURN( _TXT("failed to retrieve regular expression pattern symbol: %s"), *m_errorhnd, 0);
 	}
 
-	virtual void defineOption( const std::string& name, double)
+	virtual void defineOption( const std::string& name, double value)
 	{
 		try
 		{
@@ -1029,6 +3083,26 @@ public:
 			{
 				m_flags |= HS_FLAG_UCP;
 			}
+			else if (utils::caseInsensitiveEquals( name, "GAZETTEER"))
+			{
+				m_gazetteer = true;
+			}
+			else if (utils::caseInsensitiveEquals( name, "CASEFOLD"))
+			{
+				m_data.casefold = true;
+			}
+			else if (utils::caseInsensitiveEquals( name, "STREAM"))
+			{
+				m_data.stream = true;
+			}
+			else if (utils::caseInsensitiveEquals( name, "THREADS"))
+			{
+				if (value < 0.0 || value > 1024.0)
+				{
+					throw strus::runtime_error(_TXT("value of option '%s' out of range"), name.c_str());
+				}
+				m_data.nofThreads = (unsigned int)(value + 0.5);
+			}
 			else
 			{
 				throw strus::runtime_error(_TXT("unknown option '%s'"), name.c_str());
@@ -1044,46 +3118,155 @@ public:
 		{
 			if (m_data.patterndb) hs_free_database( m_data.patterndb);
 			m_data.patterndb = 0;
-
+			if (m_data.asciidb) hs_free_database( m_data.asciidb);
+			m_data.asciidb = 0;
+			if (m_data.editdistdb) hs_free_database( m_data.editdistdb);
+			m_data.editdistdb = 0;
+			if (m_data.streamdb) hs_free_database( m_data.streamdb);
+			m_data.streamdb = 0;
+
+			if (m_data.stream && m_data.casefold)
+			{
+				throw strus::runtime_error(_TXT("option STREAM can not be combined with option CASEFOLD"));
+			}
 			HsPatternTable hspt;
-			m_data.patternTable.complete( hspt, m_flags);
+			HsPatternTable hspt_editdist;
+			//... a text fed in chunks is only scanned by hyperscan, the gazetteer and the edit distance database scan a complete text
+			m_data.patternTable.complete( hspt, hspt_editdist, m_flags, m_gazetteer && !m_data.stream, m_data.casefold);
+			m_data.maxLexemWidth = m_data.nofThreads > 1 ? getMaxLexemWidth( hspt) : 0;
+			if (m_data.stream && hspt_editdist.arsize)
+			{
+				throw strus::runtime_error(_TXT("lexems with edit distance can not be matched with option STREAM"));
+			}
 
-			hs_platform_info_t platform;
-			std::memset( &platform, 0, sizeof(platform));
-			platform.cpu_features = HS_TUNE_FAMILY_GENERIC;
-			hs_compile_error_t* compile_err = 0;
+			// ... no Hyperscan database needed for an empty table (e.g. all lexems are matched by the gazetteer)
+			if (hspt.arsize && !compileDatabase( m_data.patterndb, hspt, HS_MODE_BLOCK))
+			{
+				return false;
+			}
+			//... the start of match is only needed for lexems shorter than the window of the text kept for rematching subexpressions
+			if (hspt.arsize && m_data.stream && !compileDatabase( m_data.streamdb, hspt, HS_MODE_STREAM | HS_MODE_SOM_HORIZON_SMALL))
+			{
+				return false;
+			}
+			//... the automaton without Unicode flags is only different and thus worth to be built if an expression depends on the flags
+			if (hspt.arsize && isUnicodeSensitivePatternTable( hspt))
+			{
+				m_data.asciidb = compileAsciiDatabase( hspt);
+			}
+			if (hspt_editdist.arsize && !compileDatabase( m_data.editdistdb, hspt_editdist, HS_MODE_BLOCK))
+			{
+				return false;
+			}
+			m_data.patternTable.releaseSources();
+			m_state = MatchPhase;
+			return true;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("failed to compile regular expression patterns: %s"), *m_errorhnd, false);
+	}
 
-			hs_error_t err =
-				hs_compile_ext_multi(
-					hspt.patternar, hspt.flagar, hspt.idar, hspt.extar, hspt.arsize, HS_MODE_BLOCK, &platform,
-					&m_data.patterndb, &compile_err);
-			if (err != HS_SUCCESS)
+	bool compileDatabase( hs_database_t*& db, const HsPatternTable& hspt, unsigned int mode)
+	{
+		hs_platform_info_t platform;
+		std::memset( &platform, 0, sizeof(platform));
+		platform.cpu_features = HS_TUNE_FAMILY_GENERIC;
+		hs_compile_error_t* compile_err = 0;
+
+		hs_error_t err =
+			hs_compile_ext_multi(
+				hspt.patternar, hspt.flagar, hspt.idar, hspt.extar, hspt.arsize, mode, &platform,
+				&db, &compile_err);
+		if (err != HS_SUCCESS)
+		{
+			if (compile_err)
 			{
-				if (compile_err)
+				const char* error_pattern = compile_err->expression < 0 ?0:hspt.patternar[ compile_err->expression];
+				if (error_pattern)
 				{
-					const char* error_pattern = compile_err->expression < 0 ?0:hspt.patternar[ compile_err->expression];
-					if (error_pattern)
-					{
-						m_errorhnd->report( _TXT( "failed to compile pattern \"%s\": %s\n"),
-									  error_pattern, compile_err->message);
-					}
-					else
-					{
-						m_errorhnd->report( _TXT( "failed to build automaton from expressions: %s\n"),
-									  compile_err->message);
-					}
-					hs_free_compile_error( compile_err);
+					m_errorhnd->report( _TXT( "failed to compile pattern \"%s\": %s\n"),
+								  error_pattern, compile_err->message);
 				}
 				else
 				{
-					m_errorhnd->report( _TXT( "unknown errpr building automaton from expressions\n"));
+					m_errorhnd->report( _TXT( "failed to build automaton from expressions: %s\n"),
+								  compile_err->message);
 				}
-				return false;
+				hs_free_compile_error( compile_err);
 			}
-			m_state = MatchPhase;
-			return true;
+			else
+			{
+				m_errorhnd->report( _TXT( "unknown errpr building automaton from expressions\n"));
+			}
+			return false;
 		}
-		CATCH_ERROR_MAP_RETURN( _TXT("failed to compile regular expression patterns: %s"), *m_errorhnd, false);
+		return true;
+	}
+
+	/// \brief Test if the automaton built from the expressions of a table depends on the Unicode flags
+	static bool isUnicodeSensitivePatternTable( const HsPatternTable& hspt)
+	{
+		std::size_t pi = 0;
+		for (; pi < hspt.arsize; ++pi)
+		{
+			if ((hspt.flagar[ pi] & (HS_FLAG_UTF8 | HS_FLAG_UCP)) != 0
+			&&  isUnicodeSensitiveExpression( hspt.patternar[ pi], hspt.flagar[ pi]))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// \brief Build an automaton for sources with ASCII characters only from the expressions without the Unicode flags
+	/// \note Changes the flags in the table passed
+	/// \return the database or 0 if the expressions are not valid without Unicode support (e.g. code points above 0xFF or Unicode properties referenced)
+	static hs_database_t* compileAsciiDatabase( HsPatternTable& hspt)
+	{
+		std::size_t pi = 0;
+		for (; pi < hspt.arsize; ++pi)
+		{
+			hspt.flagar[ pi] &= ~(HS_FLAG_UTF8 | HS_FLAG_UCP);
+		}
+		hs_platform_info_t platform;
+		std::memset( &platform, 0, sizeof(platform));
+		platform.cpu_features = HS_TUNE_FAMILY_GENERIC;
+		hs_compile_error_t* compile_err = 0;
+		hs_database_t* rt = 0;
+
+		hs_error_t err =
+			hs_compile_ext_multi(
+				hspt.patternar, hspt.flagar, hspt.idar, hspt.extar, hspt.arsize, HS_MODE_BLOCK, &platform,
+				&rt, &compile_err);
+		if (err != HS_SUCCESS)
+		{
+			if (compile_err) hs_free_compile_error( compile_err);
+			return 0;
+		}
+		return rt;
+	}
+
+	/// \brief Get an upper bound for the size of a match of any of the patterns in a table
+	/// \return the maximum match width in bytes or 0 if unbounded or unknown
+	static std::size_t getMaxLexemWidth( const HsPatternTable& hspt)
+	{
+		std::size_t rt = 0;
+		std::size_t pi = 0;
+		for (; pi < hspt.arsize; ++pi)
+		{
+			hs_expr_info_t* info = 0;
+			hs_compile_error_t* compile_err = 0;
+			hs_error_t err = hs_expression_ext_info( hspt.patternar[ pi], hspt.flagar[ pi], hspt.extar[ pi], &info, &compile_err);
+			if (err != HS_SUCCESS)
+			{
+				if (compile_err) hs_free_compile_error( compile_err);
+				return 0;
+			}
+			unsigned int width = info->max_width;
+			std::free( info);
+			if (width == std::numeric_limits<unsigned int>::max()) return 0;
+			if (width > rt) rt = width;
+		}
+		return rt;
 	}
 
 	virtual PatternLexerContextInterface* createContext() const
@@ -1105,6 +3288,7 @@ private:
 	enum State {DefinitionPhase,MatchPhase};
 	State m_state;
 	unsigned int m_flags;
+	bool m_gazetteer;
 	std::map<unsigned int,std::size_t> m_idnamemap;
 	std::string m_idnamestrings;
 };
@@ -1113,7 +3297,7 @@ private:
 std::vector<std::string> PatternLexer::getCompileOptionNames() const
 {
 	std::vector<std::string> rt;
-	static const char* ar[] = {"CASELESS", "DOTALL", "MULTILINE", "ALLOWEMPTY", "UCP", 0};
+	static const char* ar[] = {"CASELESS", "DOTALL", "MULTILINE", "ALLOWEMPTY", "UCP", "GAZETTEER", "THREADS", "CASEFOLD", "STREAM", 0};
 	for (std::size_t ai=0; ar[ai]; ++ai)
 	{
 		rt.push_back( ar[ ai]);
@@ -10,11 +10,108 @@
 #ifndef _STRUS_PATTERN_PATTERN_LEXER_IMPLEMENTATION_HPP_INCLUDED
 #define _STRUS_PATTERN_PATTERN_LEXER_IMPLEMENTATION_HPP_INCLUDED
 #include "strus/patternLexerInterface.hpp"
+#include "strus/analyzer/positionBind.hpp"
+#include <string>
+#include <vector>
 
 namespace strus {
 
 ///\brief Forward declaration
 class ErrorBufferInterface;
+///\brief Forward declaration
+class PatternLexemBatch;
+namespace analyzer {
+///\brief Forward declaration
+class PatternLexem;
+}
+
+/// \brief Extension of the lexer context implemented in this library for writing the result lexems as columnar batch
+class PatternLexerContextBatchInterface
+{
+public:
+	virtual ~PatternLexerContextBatchInterface(){}
+
+	/// \brief Detect all tokens in a text and write them to a batch
+	/// \param[out] res where to write the result lexems to (cleared before)
+	/// \param[in] src pointer to text to scan
+	/// \param[in] srclen size of text to scan in bytes
+	virtual void matchBatch( PatternLexemBatch& res, const char* src, std::size_t srclen)=0;
+};
+
+/// \brief Extension of the lexer context implemented in this library for restricting the lexems reported to a subset, e.g. of one tenant sharing the automaton with others
+class PatternLexerContextLexemMaskInterface
+{
+public:
+	virtual ~PatternLexerContextLexemMaskInterface(){}
+
+	/// \brief Define the lexems reported by the following calls of match, the events of all other lexems are dropped
+	/// \param[in] enabledIds identifiers of the lexems to report, no lexems are reported if empty
+	virtual void setLexemMask( const std::vector<unsigned int>& enabledIds)=0;
+
+	/// \brief Remove the restriction defined with setLexemMask, all lexems are reported by the following calls of match
+	virtual void clearLexemMask()=0;
+};
+
+/// \brief Extension of the lexer context implemented in this library for matching a text fed in chunks, e.g. while it is read or decompressed
+/// \note Only available for lexers compiled with the option STREAM
+class PatternLexerContextStreamInterface
+{
+public:
+	virtual ~PatternLexerContextStreamInterface(){}
+
+	/// \brief Start matching a new text, discards the state of a text not closed
+	virtual void open()=0;
+
+	/// \brief Feed the next chunk of the text opened
+	/// \param[out] res where to append the lexems not affected by the following chunks to
+	/// \param[in] chunk pointer to the chunk
+	/// \param[in] chunksize size of the chunk in bytes
+	/// \remark The chunks may split UTF-8 characters, only the last 64 KiB of the text are kept for rematching subexpressions
+	virtual void feed( std::vector<analyzer::PatternLexem>& res, const char* chunk, std::size_t chunksize)=0;
+
+	/// \brief Terminate matching the text opened
+	/// \param[out] res where to append the remaining lexems to
+	virtual void close( std::vector<analyzer::PatternLexem>& res)=0;
+};
+
+/// \brief Extension of the lexer instance implemented in this library for defining lexems as logical combination of other lexems
+/// \note The combinations are evaluated by the lexer on the matches of the lexems combined, so the pattern matcher gets one event instead of having to evaluate a rule
+class PatternLexerInstanceCombinationInterface
+{
+public:
+	virtual ~PatternLexerInstanceCombinationInterface(){}
+
+	/// \brief Define a lexem as logical combination of other lexems defined with defineLexem
+	/// \param[in] id identifier given to the lexem, 0 if the lexem is only used as part of another pattern
+	/// \param[in] expression logical expression with the operators '&' (and), '|' (or), '!' (not) and brackets on the identifiers of the lexems combined, e.g. "(12 | 13) & !14"
+	/// \param[in] span maximum distance in bytes from the start of the first to the end of the last match of the lexems combined
+	/// \param[in] level priority of the lexem in case of overlapping matches
+	/// \param[in] posbind defines how the ordinal position of the lexem is assigned
+	/// \remark A combination is evaluated at the end of every match of a lexem combined, taking only the matches starting at most 'span' bytes before into account
+	/// \remark The match of a combination reaches from the start of the first match of a lexem combined not negated to the end of the match that made it true
+	virtual void defineLexemCombination(
+			unsigned int id,
+			const std::string& expression,
+			unsigned int span,
+			unsigned int level,
+			analyzer::PositionBind posbind)=0;
+};
+
+/// \brief Extension of the lexer instance implemented in this library for exchanging the set of lexems produced and consumed with the pattern matcher
+class PatternLexerInstanceVocabularyInterface
+{
+public:
+	virtual ~PatternLexerInstanceVocabularyInterface(){}
+
+	/// \brief Get the identifiers of all lexems and symbols the lexer can produce
+	/// \return the identifiers in ascending order
+	virtual std::vector<unsigned int> getVocabulary() const=0;
+
+	/// \brief Declare the identifiers of the lexems referenced, e.g. by the pattern matcher fed with the lexems, may be called more than once, has to be called before compile
+	/// \param[in] ids identifiers of lexems referenced
+	/// \remark Lexems not referenced are left out, if they can neither influence the ordinal positions nor supersede a lexem reported
+	virtual void defineReferencedLexems( const std::vector<unsigned int>& ids)=0;
+};
 
 /// \brief Object for creating an automaton for detecting tokens defined as regular expressions in text
 /// \note Based on the Intel hyperscan library as backend.
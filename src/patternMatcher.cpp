@@ -15,14 +15,18 @@
 #include "strus/analyzer/patternMatcherResult.hpp"
 #include "strus/patternMatcherInstanceInterface.hpp"
 #include "strus/patternMatcherContextInterface.hpp"
+#include "strus/patternLexemBatch.hpp"
 #include "strus/errorBufferInterface.hpp"
 #include "strus/base/symbolTable.hpp"
 #include "strus/reference.hpp"
 #include "ruleMatcherAutomaton.hpp"
+#include "binaryImage.hpp"
 #include <map>
+#include <set>
 #include <limits>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
 
 #undef STRUS_LOWLEVEL_DEBUG
@@ -30,18 +34,60 @@
 using namespace strus;
 using namespace strus::analyzer;
 
+/// \brief Table of names in a binary image of a compiled automaton, the identifiers are the identifiers of the symbol table the image was created from
+struct NameTableImage
+{
+	const uint32_t* posar;		///< offsets of the names in strings indexed by the identifier - 1
+	uint32_t size;
+	const char* strings;		///< null terminated names
+
+	NameTableImage()
+		:posar(0),size(0),strings(0){}
+
+	const char* key( uint32_t id) const
+	{
+		return (id == 0 || id > size) ? 0 : (strings + posar[ id-1]);
+	}
+};
+
 struct PatternMatcherData
 {
 	explicit PatternMatcherData( ErrorBufferInterface* errorhnd)
-		:variableMap(),patternMap(),programTable(),exclusive(false),maxResultSize(100){}
+		:variableMap(),patternMap(),programTable(),exclusive(false),maxResultSize(100),maxResultReach(std::numeric_limits<uint32_t>::max()),variableMapImage(),patternMapImage(),hasImage(false){}
 
 	SymbolTable variableMap;
 	SymbolTable patternMap;
 	ProgramTable programTable;
 	bool exclusive;
 	unsigned int maxResultSize;
+	uint32_t maxResultReach;		///< upper bound of the distance in ordinal positions between the start of a result and any event it depends on, evaluated on compile
+	NameTableImage variableMapImage;	///< variable names, if the automaton has been loaded from an image
+	NameTableImage patternMapImage;		///< pattern names, if the automaton has been loaded from an image
+	bool hasImage;				///< true, if the automaton has been loaded from an image
+
+	const char* variableName( uint32_t id) const
+	{
+		return hasImage ? variableMapImage.key( id) : variableMap.key( id);
+	}
+	std::size_t nofVariables() const
+	{
+		return hasImage ? variableMapImage.size : variableMap.size();
+	}
+	const char* patternName( uint32_t id) const
+	{
+		return hasImage ? patternMapImage.key( id) : patternMap.key( id);
+	}
+	std::size_t nofPatterns() const
+	{
+		return hasImage ? patternMapImage.size : patternMap.size();
+	}
 };
 
+/// \brief Image layout: 4 bytes magic "SPMI", version, byte order mark, exclusive flag, maxResultSize (32 bit words each),
+///	the variable names and the pattern names as arrays of offsets and string pools, followed by the tables of the ProgramTable (see BinaryImageWriter)
+#define PATTERN_MATCHER_IMAGE_MAGIC "SPMI"
+enum {PatternMatcherImageVersion=3, PatternMatcherImageByteOrderMark=0x01020304};
+
 enum PatternEventType {TermEvent=0, ExpressionEvent=1, ReferenceEvent=2};
 static uint32_t eventHandle( PatternEventType type_, uint32_t idx)
 {
@@ -51,6 +97,7 @@ static uint32_t eventHandle( PatternEventType type_, uint32_t idx)
 
 class PatternMatcherContext
 	:public PatternMatcherContextInterface
+	,public PatternMatcherContextBatchInterface
 {
 public:
 	PatternMatcherContext( const PatternMatcherData* data_, ErrorBufferInterface* errorhnd_)
@@ -63,18 +110,7 @@ public:
 	{
 		try
 		{
-#ifdef STRUS_LOWLEVEL_DEBUG
-			std::cerr << "put input " << term.id() << " at " << term.ordpos() << std::endl;
-#endif
-			if (m_curPosition > term.ordpos())
-			{
-				throw strus::runtime_error(_TXT("term events not fed in ascending order (%u > %u)"), m_curPosition, term.ordpos());
-			}
-			else if (m_curPosition < term.ordpos())
-			{
-				m_statemachine->setCurrentPos( m_curPosition = term.ordpos());
-			}
-			else if (term.origsize() >= (std::size_t)std::numeric_limits<uint32_t>::max())
+			if (term.origsize() >= (std::size_t)std::numeric_limits<uint32_t>::max())
 			{
 				throw strus::runtime_error(_TXT("term event orig size out of range"));
 			}
@@ -86,21 +122,140 @@ public:
 			{
 				throw strus::runtime_error(_TXT("term event orig segment byte position out of range"));
 			}
-			uint32_t eventid = eventHandle( TermEvent, term.id());
-			EventData data( term.origseg(), term.origpos(), term.origseg(), term.origpos() + term.origsize(), term.ordpos(), term.ordpos()+1, 0/*subdataref*/);
-			m_statemachine->doTransition( eventid, data);
-			++m_nofEvents;
+			putInputElement( term.id(), term.ordpos(), term.origseg(), term.origpos(), term.origsize());
 		}
 		CATCH_ERROR_MAP( _TXT("failed to feed input to pattern matcher: %s"), *m_errorhnd);
 	}
 
+	virtual void putInputBatch( const PatternLexemBatch& batch)
+	{
+		try
+		{
+			feedBatch( batch);
+		}
+		CATCH_ERROR_MAP( _TXT("failed to feed input batch to pattern matcher: %s"), *m_errorhnd);
+	}
+
+	virtual void putInputArray( const analyzer::PatternLexem* ar, std::size_t size)
+	{
+		try
+		{
+			// Validate all lexems first, so that the loop feeding them needs no checks:
+			uint32_t prevpos = m_curPosition;
+			std::size_t ai = 0;
+			for (; ai != size; ++ai)
+			{
+				const analyzer::PatternLexem& term = ar[ ai];
+				if (term.origsize() >= (std::size_t)std::numeric_limits<uint32_t>::max())
+				{
+					throw strus::runtime_error(_TXT("term event orig size out of range"));
+				}
+				else if (term.origseg() >= (std::size_t)std::numeric_limits<uint32_t>::max())
+				{
+					throw strus::runtime_error(_TXT("term event orig segment number out of range"));
+				}
+				else if (term.origpos() >= (std::size_t)std::numeric_limits<uint32_t>::max())
+				{
+					throw strus::runtime_error(_TXT("term event orig segment byte position out of range"));
+				}
+				validateInputElement( term.id(), term.ordpos(), prevpos);
+				prevpos = term.ordpos();
+			}
+			for (ai=0; ai != size; ++ai)
+			{
+				const analyzer::PatternLexem& term = ar[ ai];
+				transition( term.id(), term.ordpos(), term.origseg(), term.origpos(), term.origsize());
+			}
+			m_nofEvents += size;
+		}
+		CATCH_ERROR_MAP( _TXT("failed to feed input array to pattern matcher: %s"), *m_errorhnd);
+	}
+
+	/// \brief Implementation of putInputBatch throwing on error
+	void feedBatch( const PatternLexemBatch& batch)
+	{
+		validateBatch( batch, 0, batch.size());
+		feedValidatedBatch( batch, 0, batch.size());
+	}
+
+	/// \brief Check the lexems of a range of a batch before feeding them with feedValidatedBatch
+	void validateBatch( const PatternLexemBatch& batch, std::size_t start, std::size_t end) const
+	{
+		const uint32_t* idar = batch.idar().empty() ? 0 : &batch.idar()[0];
+		const uint32_t* ordposar = batch.ordposar().empty() ? 0 : &batch.ordposar()[0];
+		uint32_t prevpos = m_curPosition;
+		std::size_t bi = start;
+		for (; bi != end; ++bi)
+		{
+			validateInputElement( idar[ bi], ordposar[ bi], prevpos);
+			prevpos = ordposar[ bi];
+		}
+	}
+
+	/// \brief Feed a range of lexems of a batch checked with validateBatch
+	void feedValidatedBatch( const PatternLexemBatch& batch, std::size_t start, std::size_t end)
+	{
+		if (start == end) return;
+		const uint32_t* idar = &batch.idar()[0];
+		const uint32_t* ordposar = &batch.ordposar()[0];
+		const uint32_t* origsegar = &batch.origsegar()[0];
+		const uint32_t* origposar = &batch.origposar()[0];
+		const uint32_t* origsizear = &batch.origsizear()[0];
+		std::size_t bi = start;
+		for (; bi != end; ++bi)
+		{
+			transition( idar[ bi], ordposar[ bi], origsegar[ bi], origposar[ bi], origsizear[ bi]);
+		}
+		m_nofEvents += end - start;
+	}
+
+	void putInputElement( unsigned int termid, unsigned int ordpos, uint32_t origseg, uint32_t origpos, uint32_t origsize)
+	{
+		validateInputElement( termid, ordpos, m_curPosition);
+		transition( termid, ordpos, origseg, origpos, origsize);
+		++m_nofEvents;
+	}
+
+	static void validateInputElement( unsigned int termid, unsigned int ordpos, uint32_t prevpos)
+	{
+		if (prevpos > ordpos)
+		{
+			throw strus::runtime_error(_TXT("term events not fed in ascending order (%u > %u)"), prevpos, ordpos);
+		}
+		if (termid >= (1U<<30))
+		{
+			throw strus::runtime_error( _TXT("event handle out of range"));
+		}
+	}
+
+	/// \brief Feed one lexem checked with validateInputElement
+	void transition( unsigned int termid, unsigned int ordpos, uint32_t origseg, uint32_t origpos, uint32_t origsize)
+	{
+#ifdef STRUS_LOWLEVEL_DEBUG
+		std::cerr << "put input " << termid << " at " << ordpos << std::endl;
+#endif
+		std::size_t nofResults = m_statemachine->results().size();
+		if (m_curPosition < ordpos)
+		{
+			m_statemachine->setCurrentPos( m_curPosition = ordpos);
+		}
+		//... the event handle of a term is its identifier (type TermEvent=0), checked by validateInputElement
+		EventData data( origseg, origpos, origseg, origpos + origsize, ordpos, ordpos+1, 0/*subdataref*/);
+		m_statemachine->doTransition( termid, data);
+		if (m_statemachine->results().size() > nofResults + 1)
+		{
+			//... results issued by one event in a defined order, so that they are the same when matching documents split into windows in parallel
+			m_statemachine->sortResults( nofResults);
+		}
+	}
+
 	void gatherResultItems( std::vector<PatternMatcherResultItem>& resitemlist, uint32_t dataref) const
 	{
 		uint32_t itemList = m_statemachine->getEventDataItemListIdx( dataref);
 		const EventItem* item;
 		while (0!=(item=m_statemachine->nextResultItem( itemList)))
 		{
-			const char* itemName = m_data->variableMap.key( item->variable);
+			const char* itemName = m_data->variableName( item->variable);
 			PatternMatcherResultItem rtitem( itemName, item->data.start_ordpos, item->data.end_ordpos, item->data.start_origseg, item->data.start_origpos, item->data.end_origseg, item->data.end_origpos);
 			resitemlist.push_back( rtitem);
 			if (item->data.subdataref)
@@ -168,7 +323,7 @@ public:
 
 	void pushResult( std::vector<analyzer::PatternMatcherResult>& res, const Result& result) const
 	{
-		const char* resultName = m_data->patternMap.key( result.resultHandle);
+		const char* resultName = m_data->patternName( result.resultHandle);
 		std::vector<PatternMatcherResultItem> rtitemlist;
 		if (result.eventDataReferenceIdx)
 		{
@@ -185,31 +340,37 @@ public:
 		try
 		{
 			std::vector<analyzer::PatternMatcherResult> rt;
-			const StateMachine::ResultList& results = m_statemachine->results();
-			rt.reserve( results.size());
-			if (m_data->exclusive)
+			getResults( rt);
+			return rt;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("failed to fetch pattern match result: %s"), *m_errorhnd, std::vector<analyzer::PatternMatcherResult>());
+	}
+
+	/// \brief Implementation of fetchResults throwing on error
+	void getResults( std::vector<analyzer::PatternMatcherResult>& rt) const
+	{
+		const StateMachine::ResultList& results = m_statemachine->results();
+		rt.reserve( results.size());
+		if (m_data->exclusive)
+		{
+			std::vector<bool> eliminate( getCoveredFlags( results));
+			std::size_t ai = 0, ae = results.size();
+			for (; ai != ae; ++ai)
 			{
-				std::vector<bool> eliminate( getCoveredFlags( results));
-				std::size_t ai = 0, ae = results.size();
-				for (; ai != ae; ++ai)
+				if (!eliminate[ai])
 				{
-					if (!eliminate[ai])
-					{
-						pushResult( rt, results[ ai]);
-					}
+					pushResult( rt, results[ ai]);
 				}
 			}
-			else
+		}
+		else
+		{
+			std::size_t ai = 0, ae = results.size();
+			for (; ai != ae; ++ai)
 			{
-				std::size_t ai = 0, ae = results.size();
-				for (; ai != ae; ++ai)
-				{
-					pushResult( rt, results[ ai]);
-				}
+				pushResult( rt, results[ ai]);
 			}
-			return rt;
 		}
-		CATCH_ERROR_MAP_RETURN( _TXT("failed to fetch pattern match result: %s"), *m_errorhnd, std::vector<analyzer::PatternMatcherResult>());
 	}
 
 	virtual analyzer::PatternMatcherStatistics getStatistics() const
@@ -233,14 +394,26 @@ public:
 	{
 		try
 		{
-			m_statemachine.reset( new StateMachine( &m_data->programTable));
-			if (!m_statemachine.get()) throw std::bad_alloc();
-			m_nofEvents = 0;
-			m_curPosition = 0;
+			clear();
 		}
 		CATCH_ERROR_MAP( _TXT("failed to get reset pattern matcher context: %s"), *m_errorhnd);
 	}
 
+	/// \brief Get the results of the state machine not yet filtered and converted
+	const StateMachine::ResultList& stateMachineResults() const
+	{
+		return m_statemachine->results();
+	}
+
+	/// \brief Implementation of reset throwing on error
+	void clear()
+	{
+		//... the state machine is cleared and not reallocated, so that the capacities of its tables are kept for the next document
+		m_statemachine->clear();
+		m_nofEvents = 0;
+		m_curPosition = 0;
+	}
+
 private:
 	ErrorBufferInterface* m_errorhnd;
 	const PatternMatcherData* m_data;
@@ -249,15 +422,190 @@ private:
 	unsigned int m_curPosition;
 };
 
+/// \brief Worker matching a range of documents of a batch with one context reused for all documents
+/// \remark The documents not processed yet are the range [start,end) of the worker. A worker takes its documents from the start of its own range.
+///	A worker without documents left steals the second half of the range of another worker, so that variable document sizes do not leave workers idle.
+class DocumentMatchWorker
+{
+public:
+	DocumentMatchWorker( const PatternMatcherData* data_, ErrorBufferInterface* errorhnd_, const std::vector<PatternLexemBatch>* documents_, std::vector<std::vector<analyzer::PatternMatcherResult> >* results_)
+		:m_mutex(),m_start(0),m_end(0),m_context(data_,errorhnd_),m_documents(documents_),m_results(results_),m_workers(0),m_error(){}
+
+	void init( std::size_t start_, std::size_t end_, const std::vector<Reference<DocumentMatchWorker> >* workers_)
+	{
+		m_start = start_;
+		m_end = end_;
+		m_workers = workers_;
+	}
+
+	void run()
+	{
+		try
+		{
+			std::size_t docidx;
+			while (fetchDocument( docidx) || (stealDocuments() && fetchDocument( docidx)))
+			{
+				m_context.clear();
+				m_context.feedBatch( (*m_documents)[ docidx]);
+				m_context.getResults( (*m_results)[ docidx]);
+			}
+		}
+		catch (const std::bad_alloc&)
+		{
+			m_error = _TXT("out of memory");
+		}
+		catch (const std::exception& err)
+		{
+			m_error = err.what();
+		}
+		catch (...)
+		{
+			//... no exception must escape the thread function
+			m_error = _TXT("unknown exception in document match worker");
+		}
+	}
+
+	const std::string& error() const
+	{
+		return m_error;
+	}
+
+	struct Runner
+	{
+		explicit Runner( DocumentMatchWorker* ref_)	:ref(ref_){}
+		void operator()()				{ref->run();}
+		DocumentMatchWorker* ref;
+	};
+
+private:
+	bool fetchDocument( std::size_t& docidx)
+	{
+		utils::ScopedLock lock( m_mutex);
+		if (m_start == m_end) return false;
+		docidx = m_start++;
+		return true;
+	}
+
+	bool stealDocuments()
+	{
+		std::size_t wi = 0, we = m_workers->size();
+		for (; wi != we; ++wi)
+		{
+			DocumentMatchWorker* victim = (*m_workers)[ wi].get();
+			if (victim == this) continue;
+			std::size_t start, end;
+			{
+				utils::ScopedLock lock( victim->m_mutex);
+				std::size_t rest = victim->m_end - victim->m_start;
+				if (!rest) continue;
+				end = victim->m_end;
+				start = end - (rest+1)/2;
+				victim->m_end = start;
+			}
+			utils::ScopedLock lock( m_mutex);
+			m_start = start;
+			m_end = end;
+			return true;
+		}
+		return false;
+	}
+
+private:
+	utils::Mutex m_mutex;
+	std::size_t m_start;
+	std::size_t m_end;
+	PatternMatcherContext m_context;
+	const std::vector<PatternLexemBatch>* m_documents;
+	std::vector<std::vector<analyzer::PatternMatcherResult> >* m_results;
+	const std::vector<Reference<DocumentMatchWorker> >* m_workers;
+	std::string m_error;
+};
+
+/// \brief Matcher of a window of a document, that is one part of the lexems of the document matched in parallel to the other parts
+/// \remark The window owns the results issued by the lexems of its own range. It is fed with the lexems of its own range preceded by the lexems in twice the maximum reach of a result before,
+///	so that every event a result owned depends on is fed. The results owned are equal to the results issued by the same lexems in the sequential matching of the whole document.
+class DocumentWindowMatcher
+{
+public:
+	DocumentWindowMatcher( const PatternMatcherData* data_, ErrorBufferInterface* errorhnd_)
+		:m_context(data_,errorhnd_),m_document(0),m_feedstart(0),m_ownstart(0),m_ownend(0),m_owned(),m_error(){}
+
+	void init( const PatternLexemBatch* document_, std::size_t feedstart_, std::size_t ownstart_, std::size_t ownend_)
+	{
+		m_document = document_;
+		m_feedstart = feedstart_;
+		m_ownstart = ownstart_;
+		m_ownend = ownend_;
+	}
+
+	void run()
+	{
+		try
+		{
+			//... the lexems of the document are validated before the windows are matched
+			m_context.clear();
+			m_owned.clear();
+			const StateMachine::ResultList& results = m_context.stateMachineResults();
+			m_context.feedValidatedBatch( *m_document, m_feedstart, m_ownstart);
+			std::size_t firstOwned = results.size();
+			m_context.feedValidatedBatch( *m_document, m_ownstart, m_ownend);
+			for (; firstOwned < results.size(); ++firstOwned)
+			{
+				m_owned.push_back( firstOwned);
+			}
+		}
+		catch (const std::bad_alloc&)
+		{
+			m_error = _TXT("out of memory");
+		}
+		catch (const std::exception& err)
+		{
+			m_error = err.what();
+		}
+		catch (...)
+		{
+			//... no exception must escape the thread function
+			m_error = _TXT("unknown exception in document window matcher");
+		}
+	}
+
+	const PatternMatcherContext& context() const		{return m_context;}
+	/// \brief Get the indices of the results owned in the list of results of the state machine of the context
+	const std::vector<std::size_t>& owned() const		{return m_owned;}
+	const std::string& error() const			{return m_error;}
+
+	struct Runner
+	{
+		explicit Runner( DocumentWindowMatcher* ref_)	:ref(ref_){}
+		void operator()()				{ref->run();}
+		DocumentWindowMatcher* ref;
+	};
+
+private:
+	PatternMatcherContext m_context;
+	const PatternLexemBatch* m_document;
+	std::size_t m_feedstart;
+	std::size_t m_ownstart;
+	std::size_t m_ownend;
+	std::vector<std::size_t> m_owned;
+	std::string m_error;
+};
+
 /// \brief Interface for building the automaton for detecting patterns in a document stream
 class PatternMatcherInstance
 	:public PatternMatcherInstanceInterface
+	,public PatternMatcherInstanceTermsInterface
+	,public PatternMatcherInstanceImageInterface
+	,public PatternMatcherInstanceBatchInterface
 {
 public:
 	explicit PatternMatcherInstance( ErrorBufferInterface* errorhnd_)
-		:m_errorhnd(errorhnd_),m_data(errorhnd_),m_stack(),m_expression_event_cnt(0),m_popt(){}
+		:m_errorhnd(errorhnd_),m_data(errorhnd_),m_stack(),m_expression_event_cnt(0),m_popt(),m_vocabulary(),m_hasVocabulary(false),m_imageFileMap(0),m_imageFileSize(0){}
 
-	virtual ~PatternMatcherInstance(){}
+	virtual ~PatternMatcherInstance()
+	{
+		utils::unmapFile( m_imageFileMap, m_imageFileSize);
+	}
 
 	virtual void defineTermFrequency( unsigned int termid, double df)
 	{
@@ -470,6 +818,10 @@ public:
 				throw strus::runtime_error(_TXT("illegal operation close pattern when no node on the stack"));
 			}
 			StackElement& elem = m_stack.back();
+			if (m_data.hasImage)
+			{
+				throw strus::runtime_error(_TXT("patterns can not be added to an automaton loaded from an image"));
+			}
 			uint32_t resultHandle = m_data.patternMap.getOrCreate( name);
 			if (resultHandle == 0)
 			{
@@ -565,11 +917,18 @@ public:
 	{
 		try
 		{
+			//... an automaton loaded from an image is already optimized
+			if (m_data.hasImage) return true;
 #ifdef STRUS_LOWLEVEL_DEBUG
 			std::cout << "automaton statistics before otimization:" << std::endl;
 			printAutomatonStatistics();
 #endif
+			if (m_hasVocabulary)
+			{
+				m_data.programTable.eliminateUnreachablePrograms( m_vocabulary);
+			}
 			m_data.programTable.optimize( m_popt);
+			m_data.maxResultReach = m_data.programTable.getMaxResultReach();
 
 #ifdef STRUS_LOWLEVEL_DEBUG
 			std::cout << "automaton statistics after otimization:" << std::endl;
@@ -580,6 +939,315 @@ public:
 		CATCH_ERROR_MAP_RETURN( _TXT("failed to compile (optimize) pattern matching automaton: %s"), *m_errorhnd, false);
 	}
 
+	virtual std::vector<unsigned int> getReferencedTerms() const
+	{
+		try
+		{
+			std::vector<unsigned int> rt;
+			std::set<uint32_t> events;
+			m_data.programTable.getTriggerEvents( events);
+			std::set<uint32_t>::const_iterator ei = events.begin(), ee = events.end();
+			for (; ei != ee; ++ei)
+			{
+				if ((*ei >> 30) == (uint32_t)TermEvent)
+				{
+					rt.push_back( *ei & ((1<<30)-1));
+				}
+			}
+			return rt;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("failed to get the terms referenced by the pattern matching automaton: %s"), *m_errorhnd, std::vector<unsigned int>());
+	}
+
+	virtual void defineTermVocabulary( const std::vector<unsigned int>& termids)
+	{
+		try
+		{
+			std::vector<unsigned int>::const_iterator ti = termids.begin(), te = termids.end();
+			for (; ti != te; ++ti)
+			{
+				m_vocabulary.insert( eventHandle( TermEvent, *ti));
+			}
+			m_hasVocabulary = true;
+		}
+		CATCH_ERROR_MAP( _TXT("failed to define the term vocabulary of the pattern matching automaton: %s"), *m_errorhnd);
+	}
+
+	virtual std::string getImage() const
+	{
+		try
+		{
+			std::string rt;
+			BinaryImageWriter writer( rt);
+			rt.append( PATTERN_MATCHER_IMAGE_MAGIC);
+			writer.writeUint32( PatternMatcherImageVersion);
+			writer.writeUint32( PatternMatcherImageByteOrderMark);
+			writer.writeUint32( m_data.exclusive ? 1:0);
+			writer.writeUint32( m_data.maxResultSize);
+			writeNameTable( writer, &PatternMatcherData::variableName, m_data.nofVariables());
+			writeNameTable( writer, &PatternMatcherData::patternName, m_data.nofPatterns());
+			m_data.programTable.exportImage( writer);
+			return rt;
+		}
+		CATCH_ERROR_MAP_RETURN( _TXT("failed to get the binary image of the pattern matching automaton: %s"), *m_errorhnd, std::string());
+	}
+
+	virtual void loadImage( const char* image, std::size_t imagesize)
+	{
+		try
+		{
+			loadImageData( image, imagesize);
+		}
+		CATCH_ERROR_MAP( _TXT("failed to load the pattern matching automaton from a binary image: %s"), *m_errorhnd);
+	}
+
+	virtual void matchDocuments( std::vector<std::vector<analyzer::PatternMatcherResult> >& results, const std::vector<PatternLexemBatch>& documents, unsigned int nofThreads) const
+	{
+		try
+		{
+			results.clear();
+			results.resize( documents.size());
+			if (documents.empty()) return;
+			if (!nofThreads) nofThreads = utils::nofHardwareThreads();
+			if (!nofThreads) nofThreads = 1;
+			if (nofThreads > documents.size()) nofThreads = documents.size();
+
+			std::vector<Reference<DocumentMatchWorker> > workers;
+			workers.reserve( nofThreads);
+			unsigned int wi = 0;
+			for (; wi < nofThreads; ++wi)
+			{
+				workers.push_back( Reference<DocumentMatchWorker>( new DocumentMatchWorker( &m_data, m_errorhnd, &documents, &results)));
+			}
+			std::size_t docsPerWorker = documents.size() / nofThreads;
+			for (wi=0; wi < nofThreads; ++wi)
+			{
+				std::size_t start = wi * docsPerWorker;
+				std::size_t end = (wi+1 == nofThreads) ? documents.size() : ((wi+1) * docsPerWorker);
+				workers[ wi]->init( start, end, &workers);
+			}
+			{
+				//... if starting a thread fails, the threads already started are joined by the destructor of the thread group before the exception is propagated
+				utils::ThreadGroup threads;
+				for (wi=1; wi < nofThreads; ++wi)
+				{
+					threads.create_thread( DocumentMatchWorker::Runner( workers[ wi].get()));
+				}
+				workers[ 0]->run();
+				threads.join_all();
+			}
+			for (wi=0; wi < nofThreads; ++wi)
+			{
+				if (!workers[ wi]->error().empty())
+				{
+					throw strus::runtime_error( "%s", workers[ wi]->error().c_str());
+				}
+			}
+		}
+		CATCH_ERROR_MAP( _TXT("failed to match a batch of documents: %s"), *m_errorhnd);
+	}
+
+	virtual void matchDocumentParallel( std::vector<analyzer::PatternMatcherResult>& results, const PatternLexemBatch& document, unsigned int nofThreads) const
+	{
+		try
+		{
+			enum {MinWindowSize=4096,MinWindowReachFactor=8};
+			results.clear();
+			if (document.empty()) return;
+			if (!nofThreads) nofThreads = utils::nofHardwareThreads();
+			if (!nofThreads) nofThreads = 1;
+
+			// Evaluate the number of windows, every window has to be big compared with the lexems fed before its own range:
+			const std::vector<uint32_t>& ordposar = document.ordposar();
+			uint32_t reach = m_data.maxResultReach;
+			std::size_t nofWindows = nofThreads;
+			if (reach >= std::numeric_limits<uint32_t>::max() / 2)
+			{
+				nofWindows = 1;
+			}
+			else
+			{
+				uint64_t ordposRange = (uint64_t)ordposar.back() - ordposar.front() + 1;
+				uint64_t maxWindows = ordposRange / ((uint64_t)(reach+1) * MinWindowReachFactor);
+				if (maxWindows < nofWindows) nofWindows = (std::size_t)maxWindows;
+				if (document.size() / MinWindowSize < nofWindows) nofWindows = document.size() / MinWindowSize;
+				if (!nofWindows) nofWindows = 1;
+			}
+
+			// Define the windows:
+			std::vector<Reference<DocumentWindowMatcher> > windows;
+			windows.reserve( nofWindows);
+			windows.push_back( Reference<DocumentWindowMatcher>( new DocumentWindowMatcher( &m_data, m_errorhnd)));
+			windows[ 0]->context().validateBatch( document, 0, document.size());
+			std::size_t lexemsPerWindow = document.size() / nofWindows;
+			std::size_t wi = 0;
+			for (; wi < nofWindows; ++wi)
+			{
+				if (wi) windows.push_back( Reference<DocumentWindowMatcher>( new DocumentWindowMatcher( &m_data, m_errorhnd)));
+				std::size_t ownstart = wi * lexemsPerWindow;
+				std::size_t ownend = (wi+1 == nofWindows) ? document.size() : ((wi+1) * lexemsPerWindow);
+				uint32_t feedstartpos = (ordposar[ ownstart] > reach * 2) ? (ordposar[ ownstart] - reach * 2) : 0;
+				std::size_t feedstart = std::lower_bound( ordposar.begin(), ordposar.begin() + ownstart, feedstartpos) - ordposar.begin();
+				windows[ wi]->init( &document, feedstart, ownstart, ownend);
+			}
+			{
+				//... if starting a thread fails, the threads already started are joined by the destructor of the thread group before the exception is propagated
+				utils::ThreadGroup threads;
+				for (wi=1; wi < nofWindows; ++wi)
+				{
+					threads.create_thread( DocumentWindowMatcher::Runner( windows[ wi].get()));
+				}
+				windows[ 0]->run();
+				threads.join_all();
+			}
+			for (wi=0; wi < nofWindows; ++wi)
+			{
+				if (!windows[ wi]->error().empty())
+				{
+					throw strus::runtime_error( "%s", windows[ wi]->error().c_str());
+				}
+			}
+
+			// Join the results owned by the windows, they are in the order of the sequential matching:
+			StateMachine::ResultList joined;
+			std::vector<std::size_t> joinedWindow;
+			for (wi=0; wi < nofWindows; ++wi)
+			{
+				const StateMachine::ResultList& windowResults = windows[ wi]->context().stateMachineResults();
+				std::vector<std::size_t>::const_iterator oi = windows[ wi]->owned().begin(), oe = windows[ wi]->owned().end();
+				for (; oi != oe; ++oi)
+				{
+					joined.add( windowResults[ *oi]);
+					joinedWindow.push_back( wi);
+				}
+			}
+			results.reserve( joined.size());
+			std::vector<bool> eliminate;
+			if (m_data.exclusive)
+			{
+				eliminate = windows[ 0]->context().getCoveredFlags( joined);
+			}
+			std::size_t ri = 0, re = joined.size();
+			for (; ri != re; ++ri)
+			{
+				if (eliminate.empty() || !eliminate[ ri])
+				{
+					windows[ joinedWindow[ ri]]->context().pushResult( results, joined[ ri]);
+				}
+			}
+		}
+		CATCH_ERROR_MAP( _TXT("failed to match a document in parallel: %s"), *m_errorhnd);
+	}
+
+	virtual void loadImageFile( const std::string& path)
+	{
+		try
+		{
+			if (m_imageFileMap)
+			{
+				throw strus::runtime_error(_TXT("image can only be loaded into an empty automaton"));
+			}
+			std::size_t imagesize;
+			const char* image = utils::mapFileReadOnly( path, imagesize);
+			try
+			{
+				loadImageData( image, imagesize);
+			}
+			catch (...)
+			{
+				utils::unmapFile( image, imagesize);
+				throw;
+			}
+			m_imageFileMap = image;
+			m_imageFileSize = imagesize;
+		}
+		CATCH_ERROR_MAP( _TXT("failed to load the pattern matching automaton from a binary image file: %s"), *m_errorhnd);
+	}
+
+private:
+	/// \brief Load the automaton from a binary image, nothing is changed if the image is rejected
+	void loadImageData( const char* image, std::size_t imagesize)
+	{
+		if (m_data.nofPatterns() || !m_stack.empty())
+		{
+			throw strus::runtime_error(_TXT("image can only be loaded into an empty automaton"));
+		}
+		std::size_t magiclen = std::strlen( PATTERN_MATCHER_IMAGE_MAGIC);
+		if (imagesize < magiclen || 0!=std::memcmp( image, PATTERN_MATCHER_IMAGE_MAGIC, magiclen))
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("unknown format"));
+		}
+		BinaryImageReader reader( image, imagesize);
+		reader.readUint32();//... magic
+		if (reader.readUint32() != (uint32_t)PatternMatcherImageVersion)
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("unsupported version"));
+		}
+		if (reader.readUint32() != (uint32_t)PatternMatcherImageByteOrderMark)
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("image created on a host with a different byte order"));
+		}
+		bool exclusive = (reader.readUint32() != 0);
+		uint32_t maxResultSize = reader.readUint32();
+		NameTableImage variableMapImage;
+		NameTableImage patternMapImage;
+		ProgramTable programTable;
+		readNameTable( variableMapImage, reader);
+		readNameTable( patternMapImage, reader);
+		programTable.importImage( reader);
+		if (!reader.eof())
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("unexpected data at end"));
+		}
+		uint32_t maxResultReach = programTable.getMaxResultReach();
+
+		//... the image is accepted, nothing can fail anymore
+		m_data.exclusive = exclusive;
+		m_data.maxResultSize = maxResultSize;
+		m_data.maxResultReach = maxResultReach;
+		m_data.variableMapImage = variableMapImage;
+		m_data.patternMapImage = patternMapImage;
+		m_data.programTable.swap( programTable);
+		m_data.hasImage = true;
+	}
+
+	typedef const char* (PatternMatcherData::*NameGetter)( uint32_t id) const;
+	void writeNameTable( BinaryImageWriter& writer, NameGetter getName, std::size_t size) const
+	{
+		std::vector<uint32_t> posar;
+		std::string strings;
+		posar.reserve( size);
+		std::size_t id = 1;
+		for (; id <= size; ++id)
+		{
+			const char* name = (m_data.*getName)( id);
+			posar.push_back( strings.size());
+			strings.append( name ? name : "");
+			strings.push_back( '\0');
+		}
+		writer.writeArray( posar.empty() ? (const uint32_t*)0 : &posar[0], posar.size());
+		writer.writeArray( strings.c_str(), strings.size());
+	}
+
+	static void readNameTable( NameTableImage& dest, BinaryImageReader& reader)
+	{
+		uint32_t stringsSize;
+		dest.posar = reader.readArray<uint32_t>( dest.size);
+		dest.strings = reader.readArray<char>( stringsSize);
+		if (stringsSize && dest.strings[ stringsSize-1] != '\0')
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("names not terminated"));
+		}
+		uint32_t ni = 0;
+		for (; ni < dest.size; ++ni)
+		{
+			if (dest.posar[ ni] >= stringsSize)
+			{
+				throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("name reference out of range"));
+			}
+		}
+	}
+
 private:
 	struct StackElement
 	{
@@ -601,6 +1269,10 @@ private:
 	std::vector<StackElement> m_stack;
 	uint32_t m_expression_event_cnt;
 	ProgramTable::OptimizeOptions m_popt;
+	std::set<uint32_t> m_vocabulary;		///< term events that can occur in the input, if defined
+	bool m_hasVocabulary;				///< true, if the term vocabulary has been defined
+	const char* m_imageFileMap;			///< image file mapped into memory, if loaded with loadImageFile
+	std::size_t m_imageFileSize;			///< size of m_imageFileMap in bytes
 };
 
 
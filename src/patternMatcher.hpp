@@ -10,6 +10,11 @@
 #ifndef _STRUS_PATTERN_MATCHER_IMPLEMENTATION_HPP_INCLUDED
 #define _STRUS_PATTERN_MATCHER_IMPLEMENTATION_HPP_INCLUDED
 #include "strus/patternMatcherInterface.hpp"
+#include "strus/analyzer/patternMatcherResult.hpp"
+#include "strus/analyzer/patternLexem.hpp"
+#include <vector>
+#include <string>
+#include <cstddef>
 
 namespace strus
 {
@@ -17,6 +22,84 @@ namespace strus
 class PatternMatcherInstanceInterface;
 /// \brief Forward declaration
 class ErrorBufferInterface;
+/// \brief Forward declaration
+class PatternLexemBatch;
+
+/// \brief Extension of the pattern matcher context implemented in this library for feeding lexems as columnar batch
+class PatternMatcherContextBatchInterface
+{
+public:
+	virtual ~PatternMatcherContextBatchInterface(){}
+
+	/// \brief Feed all lexems of a batch in ascending order of their ordinal position to the matcher
+	/// \param[in] batch lexems to feed
+	virtual void putInputBatch( const PatternLexemBatch& batch)=0;
+
+	/// \brief Feed an array of lexems in ascending order of their ordinal position to the matcher
+	/// \param[in] ar pointer to the lexems
+	/// \param[in] size number of lexems
+	/// \note The lexems are validated at once before feeding them, so nothing is fed if one of them is invalid
+	virtual void putInputArray( const analyzer::PatternLexem* ar, std::size_t size)=0;
+};
+
+/// \brief Extension of the pattern matcher instance implemented in this library for inspecting the compiled automaton
+class PatternMatcherInstanceTermsInterface
+{
+public:
+	virtual ~PatternMatcherInstanceTermsInterface(){}
+
+	/// \brief Get the identifiers of all terms triggering a program of the automaton, only defined after compile
+	/// \return the term identifiers in ascending order
+	virtual std::vector<unsigned int> getReferencedTerms() const=0;
+
+	/// \brief Declare the identifiers of all terms that can occur in the input (e.g. the vocabulary of the lexer), may be called more than once, has to be called before compile
+	/// \param[in] termids identifiers of the terms
+	/// \remark Programs that can never be triggered with these terms are removed on compile
+	virtual void defineTermVocabulary( const std::vector<unsigned int>& termids)=0;
+};
+
+/// \brief Extension of the pattern matcher instance implemented in this library for storing the compiled automaton as binary image
+class PatternMatcherInstanceImageInterface
+{
+public:
+	virtual ~PatternMatcherInstanceImageInterface(){}
+
+	/// \brief Get the binary image of the compiled automaton, only defined after compile
+	/// \return the image
+	virtual std::string getImage() const=0;
+
+	/// \brief Use the automaton of a binary image instead of defining and compiling patterns
+	/// \param[in] image pointer to the image (aligned to 8 bytes, e.g. a file mapped read only into memory), not copied, so it has to stay valid as long as this instance and its contexts are used
+	/// \param[in] imagesize size of the image in bytes
+	/// \note the image uses the byte order and structure layout of the host it was created on
+	virtual void loadImage( const char* image, std::size_t imagesize)=0;
+
+	/// \brief Use the automaton of a binary image stored in a file, mapped read only and shared into memory for the lifetime of this instance
+	/// \param[in] path path of the image file
+	/// \note all processes loading the same file share the pages of the mapping, only the state of the contexts is private per process
+	virtual void loadImageFile( const std::string& path)=0;
+};
+
+/// \brief Extension of the pattern matcher instance implemented in this library for matching many documents in parallel
+class PatternMatcherInstanceBatchInterface
+{
+public:
+	virtual ~PatternMatcherInstanceBatchInterface(){}
+
+	/// \brief Match a list of documents on a pool of threads sharing this compiled automaton
+	/// \param[out] results the results of each document in the order of the documents
+	/// \param[in] documents the lexems of each document in ascending order of their ordinal position
+	/// \param[in] nofThreads number of threads to use, 0 for the number of cores of the host
+	/// \remark Each thread reuses one state machine for all documents it processes, threads running out of documents take over documents from other threads
+	virtual void matchDocuments( std::vector<std::vector<analyzer::PatternMatcherResult> >& results, const std::vector<PatternLexemBatch>& documents, unsigned int nofThreads) const=0;
+
+	/// \brief Match one document split into windows of ordinal positions matched in parallel
+	/// \param[out] results the results of the document, the same as when matched sequentially with one context
+	/// \param[in] document the lexems of the document in ascending order of their ordinal position
+	/// \param[in] nofThreads number of threads to use, 0 for the number of cores of the host
+	/// \remark The windows overlap by the maximum reach of a result evaluated on compile, a document is matched sequentially if it is too small to be split or if the patterns are recursive
+	virtual void matchDocumentParallel( std::vector<analyzer::PatternMatcherResult>& results, const PatternLexemBatch& document, unsigned int nofThreads) const=0;
+};
 
 /// \brief Implementation of an automaton builder for detecting patterns of tokens in a document stream
 class PatternMatcher
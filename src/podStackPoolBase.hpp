@@ -16,6 +16,7 @@
 #include <limits>
 #include <stdexcept>
 #include <new>
+#include <vector>
 
 namespace strus
 {
@@ -41,6 +42,7 @@ class PodStackPoolBase
 {
 public:
 	typedef PodStructTableBase<PodStackElement<ELEMTYPE,SIZETYPE>,SIZETYPE,PodStackElement<ELEMTYPE,SIZETYPE>,BASEADDR> Parent;
+	typedef PodStackElement<ELEMTYPE,SIZETYPE> Element;
 
 	PodStackPoolBase(){}
 	PodStackPoolBase( const PodStackPoolBase& o) :Parent(o){}
@@ -148,11 +150,71 @@ public:
 		Parent::checkTable();
 	}
 
+	/// \brief Get the array of list elements
+	const PodStackElement<ELEMTYPE,SIZETYPE>* data() const
+	{
+		return Parent::data();
+	}
+	/// \brief Get the size of the array of list elements
+	SIZETYPE size() const
+	{
+		return Parent::size();
+	}
+	/// \brief Use an array of list elements not owned as content (e.g. in a binary image mapped read only into memory)
+	void attach( const PodStackElement<ELEMTYPE,SIZETYPE>* ar_, SIZETYPE size_)
+	{
+		Parent::attach( ar_, size_);
+	}
+
+	/// \brief Check that a list reference (0 for the empty list) refers to an element of the pool
+	bool isValidRef( SIZETYPE stk) const
+	{
+		return stk == 0 || Parent::exists( stk-1);
+	}
+
+	/// \brief Check that the links of all elements refer to elements of the pool and that no list is circular
+	/// \remark Needed for an array attached that was not built by this pool (e.g. in a binary image), the list accessors trust the links
+	bool checkLinks() const
+	{
+		SIZETYPE size = Parent::size();
+		const PodStackElement<ELEMTYPE,SIZETYPE>* ar = Parent::data();
+		std::vector<unsigned char> state( size, 0);	//... 0 = not visited, 1 = on the path visited, 2 = checked
+		SIZETYPE ii = 0;
+		for (; ii != size; ++ii)
+		{
+			SIZETYPE pos = ii;
+			while (state[ pos] != 2)
+			{
+				if (state[ pos] == 1) return false;
+				state[ pos] = 1;
+				SIZETYPE next = ar[ pos].next;
+				if (next == 0) break;
+				if (!isValidRef( next)) return false;
+				pos = next - 1 - Parent::first();
+			}
+			pos = ii;
+			while (state[ pos] == 1)
+			{
+				state[ pos] = 2;
+				SIZETYPE next = ar[ pos].next;
+				if (next == 0) break;
+				pos = next - 1 - Parent::first();
+			}
+		}
+		return true;
+	}
+
 	void clear()
 	{
 		Parent::clear();
 	}
 
+	/// \brief Exchange the content with another pool without copying the elements
+	void swap( PodStackPoolBase& o)
+	{
+		Parent::swap( o);
+	}
+
 private:
 	void checkCircular( SIZETYPE idx) const
 	{
@@ -16,6 +16,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <new>
+#include <algorithm>
 
 #define STRUS_USE_BASEADDR
 
@@ -120,6 +121,30 @@ public:
 	{
 		m_size = 0;
 	}
+	/// \brief Exchange the content with another array without copying the elements
+	void swap( PodStructArrayBase& o)
+	{
+		std::swap( m_ar, o.m_ar);
+		std::swap( m_allocsize, o.m_allocsize);
+		std::swap( m_size, o.m_size);
+		std::swap( m_allocated, o.m_allocated);
+	}
+
+	/// \brief Get the array of elements
+	const ELEMTYPE* data() const
+	{
+		return m_ar;
+	}
+	/// \brief Use an array not owned (e.g. in a binary image mapped read only into memory) as content
+	/// \note The array is copied when an element is added, but elements must not be modified in place
+	void attach( const ELEMTYPE* ar_, SIZETYPE size_)
+	{
+		if (m_allocated) std::free( m_ar);
+		m_ar = const_cast<ELEMTYPE*>( ar_);
+		m_allocsize = size_;
+		m_size = size_;
+		m_allocated = false;
+	}
 
 	class const_iterator
 	{
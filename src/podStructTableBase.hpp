@@ -157,6 +157,34 @@ public:
 #endif
 	}
 
+	/// \brief Exchange the content with another table without copying the elements
+	void swap( PodStructTableBase& o)
+	{
+		Parent::swap( o);
+#ifdef STRUS_CHECK_FREE_ITEMS
+		m_free_elemtab.swap( o.m_free_elemtab);
+#else
+		std::swap( m_freelistidx, o.m_freelistidx);
+#endif
+#ifdef STRUS_CHECK_USED_ITEMS
+		std::swap( m_used_size, o.m_used_size);
+#endif
+	}
+
+	/// \brief Use an array not owned as content, the free list is dropped, so free elements of the array are not reused
+	void attach( const ELEMTYPE* ar_, SIZETYPE size_)
+	{
+		Parent::attach( ar_, size_);
+#ifdef STRUS_CHECK_FREE_ITEMS
+		m_free_elemtab.clear();
+#else
+		m_freelistidx = 0;
+#endif
+#ifdef STRUS_CHECK_USED_ITEMS
+		m_used_size = size_;
+#endif
+	}
+
 	bool exists( SIZETYPE idx) const
 	{
 #ifdef STRUS_USE_BASEADDR
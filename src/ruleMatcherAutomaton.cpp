@@ -7,6 +7,7 @@
  */
 
 #include "ruleMatcherAutomaton.hpp"
+#include "binaryImage.hpp"
 #include <limits>
 #include <cstdlib>
 #include <stdexcept>
@@ -21,6 +22,11 @@
 #endif
 #define HAVE_BUILTIN_ASSUME_ALIGNED
 #endif
+#if defined(STRUS_USE_SSE_SCAN_TRIGGERS) && (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (__GNUC__ >= 5))
+//... AVX2 and AVX-512 kernels are compiled with target attributes and selected at load time, so that a build for a generic target still uses them
+#include <immintrin.h>
+#define STRUS_USE_AVX_SCAN_TRIGGERS
+#endif
 #undef STRUS_LOWLEVEL_DEBUG
 
 using namespace strus;
@@ -68,9 +74,8 @@ EventTriggerTable::TriggerInd::~TriggerInd()
 
 void EventTriggerTable::TriggerInd::clear()
 {
-	if (m_eventAr) std::free( m_eventAr);
-	if (m_ar) std::free( m_ar);
-	std::memset( this, 0, sizeof(*this));
+	//... the arrays are kept for reuse, like the arrays of the PodStructArrayBase tables
+	m_size = 0;
 }
 
 enum {EventArrayMemoryAlignment=64};
@@ -159,6 +164,19 @@ Trigger const* EventTriggerTable::getTriggerPtr( uint32_t idx) const
 	return &m_triggerTab[ idx].trigger;
 }
 
+///\brief Linear search for triggers to fire on an event without vectorization
+static void getTriggers_scalar( Trigger const** results, std::size_t& nofresults, uint32_t event, const uint32_t* eventar, const uint32_t* triggerindar, const LinkedTriggerTable& triggertab, std::size_t arsize)
+{
+	std::size_t ii = 0;
+	for (; ii < arsize; ++ii)
+	{
+		if (eventar[ii] == event)
+		{
+			results[ nofresults++] = &triggertab[ triggerindar[ ii]].trigger;
+		}
+	}
+}
+
 #ifdef STRUS_USE_SSE_SCAN_TRIGGERS
 inline std::ostream & operator << (std::ostream& out, const __v4si & val)
 {
@@ -220,6 +238,99 @@ static inline void getTriggers_SSE4( Trigger const** results, std::size_t& nofre
 }
 #endif
 
+#ifdef STRUS_USE_AVX_SCAN_TRIGGERS
+///\brief Linear search for triggers to fire on an event with AVX2, 32 words per iteration
+__attribute__((target("avx2")))
+static void getTriggers_AVX2( Trigger const** results, std::size_t& nofresults, uint32_t event, const uint32_t* eventar, const uint32_t* triggerindar, const LinkedTriggerTable& triggertab, std::size_t arsize)
+{
+	std::size_t ii = 0;
+	std::size_t nn = (arsize >> 5) << 5;		//... number of words handled in 32 word blocks
+	__m256i event8 = _mm256_set1_epi32( (int)event);
+
+	for (; ii < nn; ii += 32)
+	{
+		// Compare 4 times 8 words and collect the sign bits of the results into one 32 bit mask:
+		__m256i cmp0 = _mm256_cmpeq_epi32( event8, _mm256_load_si256( (const __m256i*)(eventar + ii + 0)));
+		__m256i cmp1 = _mm256_cmpeq_epi32( event8, _mm256_load_si256( (const __m256i*)(eventar + ii + 8)));
+		__m256i cmp2 = _mm256_cmpeq_epi32( event8, _mm256_load_si256( (const __m256i*)(eventar + ii + 16)));
+		__m256i cmp3 = _mm256_cmpeq_epi32( event8, _mm256_load_si256( (const __m256i*)(eventar + ii + 24)));
+		uint32_t res = (uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( cmp0))
+			| ((uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( cmp1)) << 8)
+			| ((uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( cmp2)) << 16)
+			| ((uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( cmp3)) << 24);
+		while (res)
+		{
+			uint32_t tz = __builtin_ctz( res);
+			results[ nofresults++] = &triggertab[ triggerindar[ ii + tz]].trigger;
+			res &= res - 1;
+		}
+	}
+	// The rest of the events modulo 32, we handle in the standard way:
+	for (; ii < arsize; ++ii)
+	{
+		if (eventar[ii] == event)
+		{
+			results[ nofresults++] = &triggertab[ triggerindar[ ii]].trigger;
+		}
+	}
+}
+
+///\brief Linear search for triggers to fire on an event with AVX-512, 64 words per iteration, the trigger indices of the matches are compressed into a buffer
+__attribute__((target("avx512f")))
+static void getTriggers_AVX512( Trigger const** results, std::size_t& nofresults, uint32_t event, const uint32_t* eventar, const uint32_t* triggerindar, const LinkedTriggerTable& triggertab, std::size_t arsize)
+{
+	std::size_t ii = 0;
+	std::size_t nn = (arsize >> 6) << 6;		//... number of words handled in 64 word blocks
+	__m512i event16 = _mm512_set1_epi32( (int)event);
+	uint32_t indbuf[ 16];
+
+	for (; ii < nn; ii += 64)
+	{
+		__mmask16 res[ 4];
+		res[0] = _mm512_cmpeq_epi32_mask( event16, _mm512_load_si512( (const void*)(eventar + ii + 0)));
+		res[1] = _mm512_cmpeq_epi32_mask( event16, _mm512_load_si512( (const void*)(eventar + ii + 16)));
+		res[2] = _mm512_cmpeq_epi32_mask( event16, _mm512_load_si512( (const void*)(eventar + ii + 32)));
+		res[3] = _mm512_cmpeq_epi32_mask( event16, _mm512_load_si512( (const void*)(eventar + ii + 48)));
+		if ((res[0] | res[1] | res[2] | res[3]) == 0) continue;
+
+		unsigned int bi = 0;
+		for (; bi < 4; ++bi)
+		{
+			if (!res[ bi]) continue;
+			// Compress the trigger indices of the matching words into a dense buffer:
+			__m512i ind = _mm512_loadu_si512( (const void*)(triggerindar + ii + bi * 16));
+			_mm512_mask_compressstoreu_epi32( (void*)indbuf, res[ bi], ind);
+			unsigned int ki = 0, ke = __builtin_popcount( (unsigned int)res[ bi]);
+			for (; ki < ke; ++ki)
+			{
+				results[ nofresults++] = &triggertab[ indbuf[ ki]].trigger;
+			}
+		}
+	}
+	// The rest of the events modulo 64, we handle in the standard way:
+	for (; ii < arsize; ++ii)
+	{
+		if (eventar[ii] == event)
+		{
+			results[ nofresults++] = &triggertab[ triggerindar[ ii]].trigger;
+		}
+	}
+}
+
+typedef void (*GetTriggersFunction)( Trigger const** results, std::size_t& nofresults, uint32_t event, const uint32_t* eventar, const uint32_t* triggerindar, const LinkedTriggerTable& triggertab, std::size_t arsize);
+
+///\brief Select the trigger scan kernel for the CPU we are running on
+static GetTriggersFunction selectGetTriggersFunction()
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports( "avx512f")) return &getTriggers_AVX512;
+	if (__builtin_cpu_supports( "avx2")) return &getTriggers_AVX2;
+	return &getTriggers_SSE4;
+}
+
+static const GetTriggersFunction g_getTriggers = selectGetTriggersFunction();
+#endif
+
 void EventTriggerTable::getTriggers( TriggerRefList& triggers, uint32_t event) const
 {
 	// The following implementation looks a little bit funny, but it is 
@@ -235,21 +346,161 @@ void EventTriggerTable::getTriggers( TriggerRefList& triggers, uint32_t event) c
 #else
 	const uint32_t* eventAr = rec.m_eventAr;
 #endif
-#ifdef STRUS_USE_SSE_SCAN_TRIGGERS
+#if defined(STRUS_USE_AVX_SCAN_TRIGGERS)
+	g_getTriggers( tar, nofresults, event, eventAr, rec.m_ar, m_triggerTab, rec.m_size);
+#elif defined(STRUS_USE_SSE_SCAN_TRIGGERS)
 	getTriggers_SSE4( tar, nofresults, event, eventAr, rec.m_ar, m_triggerTab, rec.m_size);
 #else
-	uint32_t wi=0;
-	for (; wi<rec.m_size; ++wi)
+	getTriggers_scalar( tar, nofresults, event, eventAr, rec.m_ar, m_triggerTab, rec.m_size);
+#endif
+	triggers.commit_reserved( nofresults);
+}
+
+bool EventTriggerTable::scanKernelSupported( ScanKernel kernel)
+{
+	switch (kernel)
 	{
-		if (eventAr[ wi] == event)
-		{
-			tar[ nofresults++] = &m_triggerTab[ rec.m_ar[ wi]].trigger;
-		}
+		case ScanScalar:
+			return true;
+		case ScanSSE4:
+#if defined(STRUS_USE_SSE_SCAN_TRIGGERS)
+			return true;
+#else
+			return false;
+#endif
+		case ScanAVX2:
+#if defined(STRUS_USE_AVX_SCAN_TRIGGERS)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports( "avx2");
+#else
+			return false;
+#endif
+		case ScanAVX512:
+#if defined(STRUS_USE_AVX_SCAN_TRIGGERS)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports( "avx512f");
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+void EventTriggerTable::getTriggers( TriggerRefList& triggers, uint32_t event, ScanKernel kernel) const
+{
+	if (!scanKernelSupported( kernel))
+	{
+		throw strus::runtime_error(_TXT("trigger scan kernel '%s' is not supported"), scanKernelName( kernel));
 	}
+	if (!event) return;
+	uint32_t htidx = evhash( event) & EventHashTabIdxMask;
+	const TriggerInd& rec = m_triggerIndAr[ htidx];
+	Trigger const** tar = triggers.reserve( rec.m_size);
+	std::size_t nofresults = 0;
+
+	switch (kernel)
+	{
+		case ScanScalar:
+			getTriggers_scalar( tar, nofresults, event, rec.m_eventAr, rec.m_ar, m_triggerTab, rec.m_size);
+			break;
+		case ScanSSE4:
+#if defined(STRUS_USE_SSE_SCAN_TRIGGERS)
+			getTriggers_SSE4( tar, nofresults, event, rec.m_eventAr, rec.m_ar, m_triggerTab, rec.m_size);
+#endif
+			break;
+		case ScanAVX2:
+#if defined(STRUS_USE_AVX_SCAN_TRIGGERS)
+			getTriggers_AVX2( tar, nofresults, event, rec.m_eventAr, rec.m_ar, m_triggerTab, rec.m_size);
+#endif
+			break;
+		case ScanAVX512:
+#if defined(STRUS_USE_AVX_SCAN_TRIGGERS)
+			getTriggers_AVX512( tar, nofresults, event, rec.m_eventAr, rec.m_ar, m_triggerTab, rec.m_size);
 #endif
+			break;
+	}
 	triggers.commit_reserved( nofresults);
 }
 
+void KeyEventTable::build( const std::vector<KeyEventEntry>& entries)
+{
+	clear();
+	if (entries.empty()) return;
+	if (entries.size() >= (std::size_t)(1U << 30))
+	{
+		throw std::bad_alloc();
+	}
+	// Load factor at most 0.5:
+	uint32_t size = 8;
+	while (size < entries.size() * 2) size *= 2;
+	m_ownar.resize( size);
+
+	uint32_t mask = size-1;
+	std::vector<KeyEventEntry>::const_iterator ei = entries.begin(), ee = entries.end();
+	for (; ei != ee; ++ei)
+	{
+		if (!ei->event) throw strus::runtime_error(_TXT("illegal key event (null)"));
+		uint32_t idx = hash( ei->event) & mask;
+		while (m_ownar[ idx].event)
+		{
+			if (m_ownar[ idx].event == ei->event) throw strus::runtime_error(_TXT("duplicate key event in table"));
+			idx = (idx + 1) & mask;
+		}
+		m_ownar[ idx] = *ei;
+		if (ei->stopword) ++m_nofStopWords;
+	}
+	m_ar = &m_ownar[0];
+	m_size = size;
+}
+
+void KeyEventTable::attach( const KeyEventEntry* ar, uint32_t size)
+{
+	if (size & (size-1))
+	{
+		throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("size of key event table is not a power of two"));
+	}
+	uint32_t ai = 0;
+	for (; ai < size && ar[ ai].event; ++ai){}
+	if (ai == size && size)
+	{
+		throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("key event table without empty slot"));
+	}
+	uint32_t nofStopWords = 0;
+	uint32_t maxStopWordIndex = 0;
+	for (ai = 0; ai < size; ++ai)
+	{
+		if (ar[ ai].stopword)
+		{
+			++nofStopWords;
+			if (ar[ ai].stopword > maxStopWordIndex) maxStopWordIndex = ar[ ai].stopword;
+		}
+	}
+	if (maxStopWordIndex > nofStopWords)
+	{
+		throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("stop word index out of range"));
+	}
+	m_ownar.clear();
+	m_ar = ar;
+	m_size = size;
+	m_nofStopWords = nofStopWords;
+}
+
+void KeyEventTable::clear()
+{
+	m_ownar.clear();
+	m_ar = 0;
+	m_size = 0;
+	m_nofStopWords = 0;
+}
+
+void KeyEventTable::swap( KeyEventTable& o)
+{
+	m_ownar.swap( o.m_ownar);
+	std::swap( m_ar, o.m_ar);
+	std::swap( m_size, o.m_size);
+	std::swap( m_nofStopWords, o.m_nofStopWords);
+}
+
 void ProgramTable::defineEventFrequency( uint32_t eventid, double df)
 {
 	if (df <= std::numeric_limits<double>::epsilon())
@@ -273,6 +524,7 @@ void ProgramTable::createTrigger( uint32_t programidx, uint32_t event, bool isKe
 
 void ProgramTable::doneProgram( uint32_t programidx)
 {
+	m_keyEventTable.clear();
 	Program& program = m_programMap[ programidx-1];
 	uint32_t triggerListIdx = program.triggerListIdx;
 	const TriggerDef* trigger;
@@ -284,6 +536,20 @@ void ProgramTable::doneProgram( uint32_t programidx)
 			defineEventProgram( trigger->event, programidx);
 		}
 	}
+	keyEventsChanged();
+}
+
+void ProgramTable::keyEventsChanged()
+{
+	//... the stop word indices are only available in the key event table, so it has to be rebuilt if there are stop words defined by a previous optimize
+	if (m_stopWordSet.empty())
+	{
+		m_keyEventTable.clear();
+	}
+	else
+	{
+		buildKeyEventTable( m_keyEventTable);
+	}
 }
 
 void ProgramTable::defineProgramResult( uint32_t programidx, uint32_t eventid, uint32_t resultHandle)
@@ -321,12 +587,6 @@ void ProgramTable::defineEventProgram( uint32_t eventid, uint32_t programidx)
 	++m_totalNofPrograms;
 }
 
-uint32_t ProgramTable::getEventProgramList( uint32_t eventid) const
-{
-	EventProgamTriggerMap::const_iterator ei = m_eventProgamTriggerMap.find( eventid);
-	return ei == m_eventProgamTriggerMap.end() ? 0:ei->second;
-}
-
 const ProgramTrigger* ProgramTable::nextProgramPtr( uint32_t& programlist) const
 {
 	return m_programTriggerList.nextptr( programlist);
@@ -461,14 +721,54 @@ ProgramTable::Statistics ProgramTable::getProgramStatistics() const
 		koheap.pop_back();
 	}
 	// Get list of stop events:
-	std::set<uint32_t>::const_iterator si = m_stopWordSet.begin(), se = m_stopWordSet.end();
-	for (; si != se; ++si)
+	if (m_keyEventTable.size())
 	{
-		rt.stopWordSet.push_back( *si);
+		const KeyEventEntry* ki = m_keyEventTable.data();
+		const KeyEventEntry* ke = ki + m_keyEventTable.size();
+		for (; ki != ke; ++ki)
+		{
+			if (ki->event && ki->stopword) rt.stopWordSet.push_back( ki->event);
+		}
+		std::sort( rt.stopWordSet.begin(), rt.stopWordSet.end());
+	}
+	else
+	{
+		std::set<uint32_t>::const_iterator si = m_stopWordSet.begin(), se = m_stopWordSet.end();
+		for (; si != se; ++si)
+		{
+			rt.stopWordSet.push_back( *si);
+		}
 	}
 	return rt;
 }
 
+void ProgramTable::getTriggerEvents( std::set<uint32_t>& res) const
+{
+	std::set<uint32_t> visited;
+	std::vector<std::pair<uint32_t,uint32_t> > keyEvents;
+	getKeyEventProgramLists( keyEvents);
+	std::vector<std::pair<uint32_t,uint32_t> >::const_iterator
+		ei = keyEvents.begin(),
+		ee = keyEvents.end();
+	for (; ei != ee; ++ei)
+	{
+		res.insert( ei->first);
+		uint32_t prglist = ei->second;
+		const ProgramTrigger* programTrigger;
+		while (0!=(programTrigger=m_programTriggerList.nextptr( prglist)))
+		{
+			if (!visited.insert( programTrigger->programidx).second) continue;
+			const Program& program = m_programMap[ programTrigger->programidx-1];
+			uint32_t triggerlistitr = program.triggerListIdx;
+			const TriggerDef* trigger;
+			while (0!=(trigger = m_triggerList.nextptr( triggerlistitr)))
+			{
+				res.insert( trigger->event);
+			}
+		}
+	}
+}
+
 void ProgramTable::eliminateUnusedEvents()
 {
 	std::set<uint32_t> usedEvents;
@@ -503,8 +803,364 @@ void ProgramTable::eliminateUnusedEvents()
 	}
 }
 
+typedef std::map<uint32_t,std::vector<uint32_t> > ResultEventProgramMap;
+enum {MaxResultReach=(1<<30)};
+
+/// \brief Get the reach of a program, the range of the program plus the reach of the results of other programs triggering it, doubled for the past events replayed on an alternative key event
+/// \return the reach or MaxResultReach if not bounded
+static uint32_t getProgramReach( const ProgramTable& programTable, uint32_t programidx, const ResultEventProgramMap& resultEventProgramMap, std::map<uint32_t,uint32_t>& reachMap)
+{
+	std::map<uint32_t,uint32_t>::const_iterator ri = reachMap.find( programidx);
+	if (ri != reachMap.end())
+	{
+		//... a reach of 0 marks a program visited, reached again before it is evaluated only in recursive patterns
+		return ri->second ? ri->second : (uint32_t)MaxResultReach;
+	}
+	reachMap[ programidx] = 0;
+
+	const Program& program = programTable[ programidx];
+	uint32_t maxSubReach = 0;
+	uint32_t triggerlistitr = program.triggerListIdx;
+	const TriggerDef* trigger;
+	while (0!=(trigger = programTable.triggerList().nextptr( triggerlistitr)))
+	{
+		ResultEventProgramMap::const_iterator ei = resultEventProgramMap.find( trigger->event);
+		if (ei == resultEventProgramMap.end()) continue;
+		std::vector<uint32_t>::const_iterator pi = ei->second.begin(), pe = ei->second.end();
+		for (; pi != pe; ++pi)
+		{
+			uint32_t subReach = getProgramReach( programTable, *pi, resultEventProgramMap, reachMap);
+			if (subReach > maxSubReach) maxSubReach = subReach;
+		}
+	}
+	uint64_t reach = ((uint64_t)program.positionRange + maxSubReach + 1) * 2;
+	uint32_t rt = (reach >= (uint64_t)MaxResultReach) ? (uint32_t)MaxResultReach : (uint32_t)reach;
+	reachMap[ programidx] = rt;
+	return rt;
+}
+
+uint32_t ProgramTable::getMaxResultReach() const
+{
+	// Collect all programs that can be installed:
+	std::set<uint32_t> programs;
+	std::vector<std::pair<uint32_t,uint32_t> > keyEvents;
+	getKeyEventProgramLists( keyEvents);
+	std::vector<std::pair<uint32_t,uint32_t> >::const_iterator ki = keyEvents.begin(), ke = keyEvents.end();
+	for (; ki != ke; ++ki)
+	{
+		uint32_t prglist = ki->second;
+		const ProgramTrigger* programTrigger;
+		while (0!=(programTrigger=m_programTriggerList.nextptr( prglist)))
+		{
+			programs.insert( programTrigger->programidx);
+		}
+	}
+	// Map the events issued by programs to the programs:
+	ResultEventProgramMap resultEventProgramMap;
+	std::set<uint32_t>::const_iterator pi = programs.begin(), pe = programs.end();
+	for (; pi != pe; ++pi)
+	{
+		const Program& program = m_programMap[ *pi-1];
+		if (program.slotDef.event)
+		{
+			resultEventProgramMap[ program.slotDef.event].push_back( *pi);
+		}
+	}
+	std::map<uint32_t,uint32_t> reachMap;
+	uint32_t rt = 0;
+	for (pi = programs.begin(); pi != pe; ++pi)
+	{
+		uint32_t reach = getProgramReach( *this, *pi, resultEventProgramMap, reachMap);
+		if (reach > rt) rt = reach;
+	}
+	return rt >= (uint32_t)MaxResultReach ? std::numeric_limits<uint32_t>::max() : rt;
+}
+
+void ProgramTable::getKeyEventProgramLists( std::vector<std::pair<uint32_t,uint32_t> >& res) const
+{
+	if (m_keyEventTable.size())
+	{
+		const KeyEventEntry* ki = m_keyEventTable.data();
+		const KeyEventEntry* ke = ki + m_keyEventTable.size();
+		for (; ki != ke; ++ki)
+		{
+			if (ki->programlist) res.push_back( std::pair<uint32_t,uint32_t>( ki->event, ki->programlist));
+		}
+	}
+	else
+	{
+		EventProgamTriggerMap::const_iterator
+			ei = m_eventProgamTriggerMap.begin(),
+			ee = m_eventProgamTriggerMap.end();
+		for (; ei != ee; ++ei)
+		{
+			res.push_back( std::pair<uint32_t,uint32_t>( ei->first, ei->second));
+		}
+	}
+}
+
+void ProgramTable::buildKeyEventTable( KeyEventTable& res) const
+{
+	// Entries inserted in ascending order of the events, so that the layout of the table does not depend on the order of the hash map:
+	std::map<uint32_t,KeyEventEntry> entrymap;
+	EventProgamTriggerMap::const_iterator
+		ei = m_eventProgamTriggerMap.begin(),
+		ee = m_eventProgamTriggerMap.end();
+	for (; ei != ee; ++ei)
+	{
+		entrymap[ ei->first] = KeyEventEntry( ei->first, ei->second, 0);
+	}
+	// Stop words get dense indices in ascending order of the events:
+	uint32_t stopWordIndex = 0;
+	std::set<uint32_t>::const_iterator si = m_stopWordSet.begin(), se = m_stopWordSet.end();
+	for (; si != se; ++si)
+	{
+		KeyEventEntry& entry = entrymap[ *si];
+		entry.event = *si;
+		entry.stopword = ++stopWordIndex;
+	}
+	std::vector<KeyEventEntry> entries;
+	entries.reserve( entrymap.size());
+	std::map<uint32_t,KeyEventEntry>::const_iterator mi = entrymap.begin(), me = entrymap.end();
+	for (; mi != me; ++mi)
+	{
+		entries.push_back( mi->second);
+	}
+	res.build( entries);
+}
+
+void ProgramTable::exportImage( BinaryImageWriter& writer) const
+{
+	writer.writeArray( m_programMap.data(), m_programMap.size());
+	writer.writeArray( m_triggerList.data(), m_triggerList.size());
+	writer.writeArray( m_programTriggerList.data(), m_programTriggerList.size());
+	if (m_keyEventTable.size())
+	{
+		writer.writeArray( m_keyEventTable.data(), m_keyEventTable.size());
+	}
+	else
+	{
+		KeyEventTable keyEventTable;
+		buildKeyEventTable( keyEventTable);
+		writer.writeArray( keyEventTable.data(), keyEventTable.size());
+	}
+}
+
+void ProgramTable::importImage( BinaryImageReader& reader)
+{
+	uint32_t size;
+	const Program* programar = reader.readArray<Program>( size);
+	m_programMap.attach( programar, size);
+	m_totalNofPrograms = size;
+	const TriggerDefList::Element* triggerar = reader.readArray<TriggerDefList::Element>( size);
+	m_triggerList.attach( triggerar, size);
+	const ProgramTriggerList::Element* programtriggerar = reader.readArray<ProgramTriggerList::Element>( size);
+	m_programTriggerList.attach( programtriggerar, size);
+	const KeyEventEntry* keyEventAr = reader.readArray<KeyEventEntry>( size);
+	m_keyEventTable.attach( keyEventAr, size);
+
+	//... the matcher follows the indices of the image without checking them, so they are checked here once
+	if (!m_triggerList.checkLinks())
+	{
+		throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("invalid link in trigger list"));
+	}
+	if (!m_programTriggerList.checkLinks())
+	{
+		throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("invalid link in program trigger list"));
+	}
+	uint32_t pi = 0, pe = m_programMap.size();
+	for (; pi != pe; ++pi)
+	{
+		if (!m_triggerList.isValidRef( programar[ pi].triggerListIdx))
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("trigger list index of program out of range"));
+		}
+	}
+	uint32_t ti = 0, te = m_programTriggerList.size();
+	for (; ti != te; ++ti)
+	{
+		uint32_t programidx = programtriggerar[ ti].value.programidx;
+		if (programidx == 0 || !m_programMap.exists( programidx-1))
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("program index of program trigger out of range"));
+		}
+	}
+	uint32_t ki = 0, ke = m_keyEventTable.size();
+	for (; ki != ke; ++ki)
+	{
+		if (!m_programTriggerList.isValidRef( keyEventAr[ ki].programlist))
+		{
+			throw strus::runtime_error(_TXT("corrupt binary image: %s"), _TXT("program list index of key event out of range"));
+		}
+	}
+
+	//... data only needed for building and optimizing the tables, the matcher uses the key event table
+	m_eventProgamTriggerMap.clear();
+	m_stopWordSet.clear();
+	m_keyOccurrenceMap.clear();
+	m_eventOccurrenceMap.clear();
+	m_frequencyMap.clear();
+}
+
+void ProgramTable::swap( ProgramTable& o)
+{
+	m_actionSlotArray.swap( o.m_actionSlotArray);
+	m_triggerList.swap( o.m_triggerList);
+	m_programMap.swap( o.m_programMap);
+	m_programTriggerList.swap( o.m_programTriggerList);
+	m_eventProgamTriggerMap.swap( o.m_eventProgamTriggerMap);
+	m_stopWordSet.swap( o.m_stopWordSet);
+	m_keyEventTable.swap( o.m_keyEventTable);
+	m_keyOccurrenceMap.swap( o.m_keyOccurrenceMap);
+	m_eventOccurrenceMap.swap( o.m_eventOccurrenceMap);
+	m_frequencyMap.swap( o.m_frequencyMap);
+	std::swap( m_totalNofPrograms, o.m_totalNofPrograms);
+}
+
+bool ProgramTable::isProgramReachable( const Program& program, const std::set<uint32_t>& possibleEvents) const
+{
+	uint32_t nofTriggers = 0;
+	uint32_t nofPossible = 0;
+	bool isAny = false;
+	uint32_t triggerlistitr = program.triggerListIdx;
+	const TriggerDef* trigger;
+	while (0!=(trigger = m_triggerList.nextptr( triggerlistitr)))
+	{
+		//... structure delimiters are not required for a match
+		if (trigger->sigtype == Trigger::SigDel) continue;
+		++nofTriggers;
+		if (possibleEvents.find( trigger->event) != possibleEvents.end()) ++nofPossible;
+		if (trigger->sigtype == Trigger::SigAny) isAny = true;
+	}
+	if (!nofPossible) return false;
+	if (isAny) return true;
+	// ... all arguments are required, if the number of arguments needed (cardinality) is not smaller than the number of arguments:
+	return nofPossible == nofTriggers || program.slotDef.initcount < nofTriggers;
+}
+
+void ProgramTable::eliminateUnreachablePrograms( const std::set<uint32_t>& termEvents)
+{
+	m_keyEventTable.clear();
+	// Collect all programs installed by a key event:
+	std::set<uint32_t> programs;
+	EventProgamTriggerMap::iterator
+		ei = m_eventProgamTriggerMap.begin(),
+		ee = m_eventProgamTriggerMap.end();
+	for (; ei != ee; ++ei)
+	{
+		uint32_t prglist = ei->second;
+		const ProgramTrigger* programTrigger;
+		while (0!=(programTrigger=m_programTriggerList.nextptr( prglist)))
+		{
+			programs.insert( programTrigger->programidx);
+		}
+	}
+	// Calculate the events that can occur as fixpoint, starting with the terms, the result events of the programs reachable are added in each iteration:
+	std::set<uint32_t> possibleEvents( termEvents);
+	std::set<uint32_t> reachablePrograms;
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		std::set<uint32_t>::const_iterator pi = programs.begin(), pe = programs.end();
+		for (; pi != pe; ++pi)
+		{
+			if (reachablePrograms.find( *pi) != reachablePrograms.end()) continue;
+			const Program& program = m_programMap[ *pi-1];
+			if (isProgramReachable( program, possibleEvents))
+			{
+				reachablePrograms.insert( *pi);
+				if (program.slotDef.event) possibleEvents.insert( program.slotDef.event);
+				changed = true;
+			}
+		}
+	}
+	if (reachablePrograms.size() == programs.size() && possibleEvents.size() >= m_eventProgamTriggerMap.size())
+	{
+		bool allKeyEventsPossible = true;
+		for (ei = m_eventProgamTriggerMap.begin(); ei != ee && allKeyEventsPossible; ++ei)
+		{
+			allKeyEventsPossible = (possibleEvents.find( ei->first) != possibleEvents.end());
+		}
+		if (allKeyEventsPossible) return;
+	}
+	// Remove the key events that can not occur and the programs not reachable from the program lists of the key events:
+	std::vector<uint32_t> keyEventsToDelete;
+	for (ei = m_eventProgamTriggerMap.begin(); ei != ee; ++ei)
+	{
+		if (possibleEvents.find( ei->first) == possibleEvents.end())
+		{
+			keyEventsToDelete.push_back( ei->first);
+			continue;
+		}
+		uint32_t prglist = ei->second;
+		uint32_t new_prglist = 0;
+		std::size_t nofDeletes = 0;
+		const ProgramTrigger* programTrigger;
+		while (0!=(programTrigger=m_programTriggerList.nextptr( prglist)))
+		{
+			if (reachablePrograms.find( programTrigger->programidx) == reachablePrograms.end())
+			{
+				++nofDeletes;
+			}
+			else
+			{
+				m_programTriggerList.push( new_prglist, *programTrigger);
+			}
+		}
+		if (nofDeletes)
+		{
+			m_programTriggerList.remove( ei->second);
+			m_keyOccurrenceMap[ ei->first] -= (uint32_t)nofDeletes;
+			if (new_prglist != 0)
+			{
+				ei->second = new_prglist;
+			}
+			else
+			{
+				keyEventsToDelete.push_back( ei->first);
+			}
+		}
+		else if (new_prglist)
+		{
+			m_programTriggerList.remove( new_prglist);
+		}
+	}
+	std::vector<uint32_t>::const_iterator ki = keyEventsToDelete.begin(), ke = keyEventsToDelete.end();
+	for (; ki != ke; ++ki)
+	{
+		EventProgamTriggerMap::iterator mi = m_eventProgamTriggerMap.find( *ki);
+		if (mi == m_eventProgamTriggerMap.end()) continue;
+		if (mi->second && possibleEvents.find( *ki) == possibleEvents.end())
+		{
+			m_programTriggerList.remove( mi->second);
+		}
+		m_eventProgamTriggerMap.erase( mi);
+		m_keyOccurrenceMap.erase( *ki);
+	}
+	// Free the programs not reachable:
+	std::set<uint32_t>::const_iterator pi = programs.begin(), pe = programs.end();
+	for (; pi != pe; ++pi)
+	{
+		if (reachablePrograms.find( *pi) != reachablePrograms.end()) continue;
+		Program& program = m_programMap[ *pi-1];
+		uint32_t triggerlistitr = program.triggerListIdx;
+		const TriggerDef* trigger;
+		while (0!=(trigger = m_triggerList.nextptr( triggerlistitr)))
+		{
+			EventOccurrenceMap::iterator oi = m_eventOccurrenceMap.find( trigger->event);
+			if (oi != m_eventOccurrenceMap.end() && oi->second) oi->second -= 1;
+		}
+		if (program.triggerListIdx) m_triggerList.remove( program.triggerListIdx);
+		m_programMap.remove( *pi-1);
+		--m_totalNofPrograms;
+	}
+	keyEventsChanged();
+}
+
 void ProgramTable::optimize( OptimizeOptions& opt)
 {
+	m_keyEventTable.clear();
 	eliminateUnusedEvents();
 
 	// Evaluate the key event identifiers to replace:
@@ -577,6 +1233,7 @@ void ProgramTable::optimize( OptimizeOptions& opt)
 			m_eventProgamTriggerMap.erase( ei);
 		}
 	}
+	buildKeyEventTable( m_keyEventTable);
 }
 
 
@@ -589,9 +1246,10 @@ StateMachine::StateMachine( const ProgramTable* programTable_)
 	,m_nofOpenPatterns(0.0)
 	,m_timestmp(0)
 {
-	std::memset( m_disposeWindow, 0, sizeof(m_disposeWindow));
-	std::make_heap( m_ruleDisposeQueue.begin(), m_ruleDisposeQueue.end());
+	std::memset( m_disposeWheel, 0, sizeof(m_disposeWheel));
+	std::memset( m_disposeWheelOccupied, 0, sizeof(m_disposeWheelOccupied));
 	std::memset( m_observeEvents, 0, sizeof(m_observeEvents));
+	m_stopWordsEventLogAr.resize( m_programTable->nofStopWords());
 }
 
 StateMachine::StateMachine( const StateMachine& o)
@@ -605,19 +1263,36 @@ StateMachine::StateMachine( const StateMachine& o)
 	,m_results(o.m_results)
 	,m_curpos(o.m_curpos)
 	,m_disposeRuleList(o.m_disposeRuleList)
-	,m_ruleDisposeQueue(o.m_ruleDisposeQueue)
-	,m_stopWordsEventLogMap(o.m_stopWordsEventLogMap)
+	,m_stopWordsEventLogAr(o.m_stopWordsEventLogAr)
 	,m_nofProgramsInstalled(o.m_nofProgramsInstalled)
 	,m_nofAltKeyProgramsInstalled(o.m_nofAltKeyProgramsInstalled)
 	,m_nofSignalsFired(o.m_nofSignalsFired)
 	,m_nofOpenPatterns(o.m_nofOpenPatterns)
 	,m_timestmp(o.m_timestmp)
 {
-	std::memcpy( m_disposeWindow, o.m_disposeWindow, sizeof(m_disposeWindow));
-	std::make_heap( m_ruleDisposeQueue.begin(), m_ruleDisposeQueue.end());
+	std::memcpy( m_disposeWheel, o.m_disposeWheel, sizeof(m_disposeWheel));
+	std::memcpy( m_disposeWheelOccupied, o.m_disposeWheelOccupied, sizeof(m_disposeWheelOccupied));
 	std::memcpy( m_observeEvents, o.m_observeEvents, sizeof(m_observeEvents));
 }
 
+static bool compareResultOrder( const Result& aa, const Result& bb)
+{
+	if (aa.start_ordpos != bb.start_ordpos) return aa.start_ordpos < bb.start_ordpos;
+	if (aa.end_ordpos != bb.end_ordpos) return aa.end_ordpos < bb.end_ordpos;
+	if (aa.resultHandle != bb.resultHandle) return aa.resultHandle < bb.resultHandle;
+	if (aa.start_origseg != bb.start_origseg) return aa.start_origseg < bb.start_origseg;
+	if (aa.start_origpos != bb.start_origpos) return aa.start_origpos < bb.start_origpos;
+	if (aa.end_origseg != bb.end_origseg) return aa.end_origseg < bb.end_origseg;
+	return aa.end_origpos < bb.end_origpos;
+}
+
+void StateMachine::sortResults( std::size_t startidx)
+{
+	if (startidx + 1 >= m_results.size()) return;
+	Result* ar = &m_results[ 0];
+	std::stable_sort( ar + startidx, ar + m_results.size(), compareResultOrder);
+}
+
 void StateMachine::addObserveEvent( uint32_t event)
 {
 	std::size_t ei = 0, ee = MaxNofObserveEvents;
@@ -653,11 +1328,10 @@ void StateMachine::clear()
 	m_ruleTable.clear();
 	m_results.clear();
 	m_curpos = 0;
-	std::memset( m_disposeWindow, 0, sizeof(m_disposeWindow));
+	std::memset( m_disposeWheel, 0, sizeof(m_disposeWheel));
+	std::memset( m_disposeWheelOccupied, 0, sizeof(m_disposeWheelOccupied));
 	m_disposeRuleList.clear();
-	m_ruleDisposeQueue.clear();
-	std::make_heap( m_ruleDisposeQueue.begin(), m_ruleDisposeQueue.end());
-	m_stopWordsEventLogMap.clear();
+	m_stopWordsEventLogAr.assign( m_programTable->nofStopWords(), EventLog());
 	m_nofProgramsInstalled = 0;
 	m_nofAltKeyProgramsInstalled = 0;
 	m_nofSignalsFired = 0;
@@ -776,7 +1450,7 @@ void StateMachine::fireSignal(
 	++m_nofSignalsFired;
 
 #ifdef STRUS_LOWLEVEL_DEBUG
-	bool observed = isObservedEvent( slot.event);
+	bool observed = isObservedEvent( (*m_programTable)[ slot.program].slotDef.event);
 	if (observed)
 	{
 		std::cout << "rule " << slot.rule << " fire sig " << Trigger::sigTypeName( trigger.sigtype()) << "(" << std::hex << trigger.sigval() << ") at " << slot.value << "#" << std::dec << slot.count;
@@ -926,20 +1600,21 @@ void StateMachine::fireSignal(
 	}
 	if (match)
 	{
-		if (!rule.done)
+		if (!slot.done)
 		{
-			if (slot.event)
+			const ActionSlotDef& slotDef = (*m_programTable)[ slot.program].slotDef;
+			if (slotDef.event)
 			{
-				EventStruct followEventData( EventData( slot.start_origseg, slot.start_origpos, data.end_origseg, data.end_origpos, slot.start_ordpos, slot.end_ordpos, rule.eventDataReferenceIdx), slot.event);
+				EventStruct followEventData( EventData( slot.start_origseg, slot.start_origpos, data.end_origseg, data.end_origpos, slot.start_ordpos, slot.end_ordpos, rule.eventDataReferenceIdx), slotDef.event);
 				if (rule.eventDataReferenceIdx)
 				{
 					referenceEventData( rule.eventDataReferenceIdx);
 				}
 				followList.add( followEventData);
 			}
-			if (slot.resultHandle)
+			if (slotDef.resultHandle)
 			{
-				m_results.add( Result( slot.resultHandle, rule.eventDataReferenceIdx, slot.start_ordpos, slot.end_ordpos, slot.start_origseg, slot.start_origpos, data.end_origseg, data.end_origpos));
+				m_results.add( Result( slotDef.resultHandle, rule.eventDataReferenceIdx, slot.start_ordpos, slot.end_ordpos, slot.start_origseg, slot.start_origpos, data.end_origseg, data.end_origpos));
 				if (rule.eventDataReferenceIdx)
 				{
 					referenceEventData( rule.eventDataReferenceIdx);
@@ -951,7 +1626,7 @@ void StateMachine::fireSignal(
 				}
 #endif
 			}
-			rule.done = true;
+			slot.done = 1;
 #ifdef STRUS_LOWLEVEL_DEBUG
 			if (observed)
 			{
@@ -1028,9 +1703,14 @@ void StateMachine::doTransition( uint32_t event, const EventData& data)
 
 		// Keep all stopword events to feed slots of programs triggered by a key event 
 		// that is not the first appearing:
-		if (m_programTable->isStopWord( follow.eventid))
+		uint32_t stopWordIndex = m_programTable->stopWordIndex( follow.eventid);
+		if (stopWordIndex)
 		{
-			m_stopWordsEventLogMap[ follow.eventid] = EventLog( follow.data, ++m_timestmp);
+			if (stopWordIndex > m_stopWordsEventLogAr.size())
+			{
+				m_stopWordsEventLogAr.resize( m_programTable->nofStopWords());
+			}
+			m_stopWordsEventLogAr[ stopWordIndex-1] = EventLog( follow.data, ++m_timestmp);
 		}
 		// Release event data not referenced by any active rule:
 		else if (follow.data.subdataref)
@@ -1046,22 +1726,71 @@ void StateMachine::doTransition( uint32_t event, const EventData& data)
 #endif
 }
 
+static inline unsigned int highestBitIndex( uint32_t val)
+{
+#if defined(__GNUC__)
+	return 31 - __builtin_clz( val);
+#else
+	unsigned int rt = 0;
+	while (val >>= 1) ++rt;
+	return rt;
+#endif
+}
+
+static inline unsigned int lowestBitIndex( uint64_t val)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll( val);
+#else
+	unsigned int rt = 0;
+	for (; 0==(val & 1); val >>= 1) ++rt;
+	return rt;
+#endif
+}
+
+/// \brief Get the bit mask of the slots [from,to) of a level of the timing wheel
+static inline uint64_t slotRangeMask( unsigned int from, unsigned int to)
+{
+	uint64_t upto = (to >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << to) - 1);
+	uint64_t below = (from >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << from) - 1);
+	return upto & ~below;
+}
+
+void StateMachine::insertDisposeEvent( const DisposeEvent& ev)
+{
+	uint32_t diff = ev.pos ^ m_curpos;
+	unsigned int level = diff ? (highestBitIndex( diff) / DisposeWheelLevelBits) : 0;
+	unsigned int slot = (ev.pos >> (level * DisposeWheelLevelBits)) & (DisposeWheelSlots-1);
+	m_disposeRuleList.push( m_disposeWheel[ level][ slot], ev);
+	m_disposeWheelOccupied[ level] |= (uint64_t)1 << slot;
+}
+
+unsigned int StateMachine::disposeWheelSlots( unsigned int level, uint64_t slotmask)
+{
+	unsigned int rt = 0;
+	uint64_t occupied = m_disposeWheelOccupied[ level] & slotmask;
+	m_disposeWheelOccupied[ level] &= ~slotmask;
+	while (occupied)
+	{
+		unsigned int slot = lowestBitIndex( occupied);
+		occupied &= occupied - 1;
+		DisposeEvent ev;
+		while (m_disposeRuleList.pop( m_disposeWheel[ level][ slot], ev))
+		{
+			disposeRule( ev.idx);
+			++rt;
+		}
+	}
+	return rt;
+}
+
 void StateMachine::defineDisposeRule( uint32_t pos, uint32_t ruleidx)
 {
 	if (pos < m_curpos)
 	{
 		throw strus::runtime_error(_TXT("illegal definition of dispose rule at position %u (smaller than current %u)"), pos, m_curpos);
 	}
-	if (pos < m_curpos + DisposeWindowSize)
-	{
-		uint32_t widx = pos % DisposeWindowSize;
-		m_disposeRuleList.push( m_disposeWindow[ widx], ruleidx);
-	}
-	else
-	{
-		m_ruleDisposeQueue.push_back( DisposeEvent( pos, ruleidx));
-		std::push_heap( m_ruleDisposeQueue.begin(), m_ruleDisposeQueue.end());
-	}
+	insertDisposeEvent( DisposeEvent( pos, ruleidx));
 }
 
 void StateMachine::setCurrentPos( uint32_t pos)
@@ -1071,52 +1800,50 @@ void StateMachine::setCurrentPos( uint32_t pos)
 		throw strus::runtime_error(_TXT("illegal definition of current pos (positions not ascending: %u ... %u)"), m_curpos, pos);
 	}
 	if (m_curpos == pos) return;
-#ifdef STRUS_LOWLEVEL_DEBUG
-	int disposeCount = 0;
-#endif
-	std::size_t wcnt=0;
-	for (; wcnt < DisposeWindowSize && m_curpos < pos; ++wcnt,++m_curpos)
+	unsigned int disposeCount = 0;
+	unsigned int toplevel = highestBitIndex( m_curpos ^ pos) / DisposeWheelLevelBits;
+	unsigned int shift = toplevel * DisposeWheelLevelBits;
+	unsigned int curslot = (m_curpos >> shift) & (DisposeWheelSlots-1);
+	unsigned int newslot = (pos >> shift) & (DisposeWheelSlots-1);
+
+	// All events on the levels below the top level changed share the upper bits of the old position, so they are all before the new position:
+	unsigned int li = 0;
+	for (; li < toplevel; ++li)
+	{
+		disposeCount += disposeWheelSlots( li, ~(uint64_t)0);
+	}
+	if (toplevel == 0)
+	{
+		disposeCount += disposeWheelSlots( 0, slotRangeMask( curslot, newslot));
+		m_curpos = pos;
+	}
+	else
 	{
-		uint32_t rulelist;
-		uint32_t widx = m_curpos % DisposeWindowSize;
-		if (widx == 0)
+		// Slots of the top level between the old and the new slot are before the new position, the new slot is cascaded down to the lower levels:
+		disposeCount += disposeWheelSlots( toplevel, slotRangeMask( curslot+1, newslot));
+		uint32_t cascade = m_disposeWheel[ toplevel][ newslot];
+		m_disposeWheel[ toplevel][ newslot] = 0;
+		m_disposeWheelOccupied[ toplevel] &= ~((uint64_t)1 << newslot);
+		m_curpos = pos;
+
+		DisposeEvent ev;
+		while (m_disposeRuleList.pop( cascade, ev))
 		{
-			while (!m_ruleDisposeQueue.empty() && m_ruleDisposeQueue.front().pos < m_curpos + DisposeWindowSize)
+			if (ev.pos < m_curpos)
 			{
-				wcnt = 0;
-				m_disposeRuleList.push( m_disposeWindow[ m_ruleDisposeQueue.front().pos % DisposeWindowSize], m_ruleDisposeQueue.front().idx);
-				std::pop_heap( m_ruleDisposeQueue.begin(), m_ruleDisposeQueue.end());
-				m_ruleDisposeQueue.pop_back();
+				disposeRule( ev.idx);
+				++disposeCount;
 			}
-		}
-		if (0!=(rulelist = m_disposeWindow[ widx]))
-		{
-			uint32_t ruleidx;
-			while (m_disposeRuleList.next( rulelist, ruleidx))
+			else
 			{
-				disposeRule( ruleidx);
-#ifdef STRUS_LOWLEVEL_DEBUG
-				disposeCount += 1;
-#endif
+				insertDisposeEvent( ev);
 			}
-			m_disposeWindow[ widx] = 0;
-		}
-	}
-	if (m_curpos < pos)
-	{
-		m_curpos = pos;
-		while (!m_ruleDisposeQueue.empty() && m_ruleDisposeQueue.front().pos < m_curpos)
-		{
-			disposeRule( m_ruleDisposeQueue.front().idx);
-#ifdef STRUS_LOWLEVEL_DEBUG
-			disposeCount += 1;
-#endif
-			std::pop_heap( m_ruleDisposeQueue.begin(), m_ruleDisposeQueue.end());
-			m_ruleDisposeQueue.pop_back();
 		}
 	}
 #ifdef STRUS_LOWLEVEL_DEBUG
 	std::cout << "set current position " << pos << ", rules deleted " << disposeCount << ", nof rules used " << m_ruleTable.used_size() << ", nof active triggers " << m_eventTriggerTable.nofTriggers() << std::endl;
+#else
+	(void)disposeCount;
 #endif
 }
 
@@ -1175,7 +1902,7 @@ void StateMachine::installProgram( uint32_t keyevent, const ProgramTrigger& prog
 	rule.actionSlotIdx =
 		1+m_actionSlotTable.add(
 			ActionSlot( program.slotDef.initsigval, program.slotDef.initcount,
-					program.slotDef.event, ruleidx, program.slotDef.resultHandle));
+					programTrigger.programidx, ruleidx));
 
 	ActionSlot& slot = m_actionSlotTable[ rule.actionSlotIdx-1];
 	uint32_t program_triggerListItr = program.triggerListIdx;
@@ -1252,13 +1979,20 @@ void StateMachine::installProgram( uint32_t keyevent, const ProgramTrigger& prog
 	}
 }
 
+const EventLog* StateMachine::getStopWordEventLog( uint32_t eventid) const
+{
+	uint32_t stopWordIndex = m_programTable->stopWordIndex( eventid);
+	if (!stopWordIndex || stopWordIndex > m_stopWordsEventLogAr.size()) return 0;
+	const EventLog* rt = &m_stopWordsEventLogAr[ stopWordIndex-1];
+	return rt->timestmp ? rt : 0;
+}
+
 void StateMachine::replayPastEvent( uint32_t eventid, const Rule& rule, uint32_t positionRange)
 {
 	// Search for the event 'eventid' in the latest visited stopwords and trigger them
 	// to fire on the slot of the installed rule
-	std::map<uint32_t,EventLog>::const_iterator
-		ei = m_stopWordsEventLogMap.find( eventid);
-	if (ei != m_stopWordsEventLogMap.end() && ei->second.data.start_ordpos + positionRange >= m_curpos)
+	const EventLog* eventLog = getStopWordEventLog( eventid);
+	if (eventLog && eventLog->data.start_ordpos + positionRange >= m_curpos)
 	{
 		ActionSlot& slot = m_actionSlotTable[ rule.actionSlotIdx-1];
 
@@ -1283,7 +2017,7 @@ void StateMachine::replayPastEvent( uint32_t eventid, const Rule& rule, uint32_t
 			}
 			if (eventid == trigger_eventid)
 			{
-				fireSignal( slot, *tp, ei->second.data, disposeRuleList, followList);
+				fireSignal( slot, *tp, eventLog->data, disposeRuleList, followList);
 			}
 		}
 		if (delEventList.size())
@@ -1293,9 +2027,8 @@ void StateMachine::replayPastEvent( uint32_t eventid, const Rule& rule, uint32_t
 				le = delEventList.end();
 			for (; li != le; ++li)
 			{
-				std::map<uint32_t,EventLog>::const_iterator
-					stopwi = m_stopWordsEventLogMap.find( *li);
-				if (stopwi != m_stopWordsEventLogMap.end() && stopwi->second.timestmp > ei->second.timestmp)
+				const EventLog* delEventLog = getStopWordEventLog( *li);
+				if (delEventLog && delEventLog->timestmp > eventLog->timestmp)
 				{
 					deactivateRule( slot.rule);
 					break;
@@ -17,12 +17,19 @@
 #include "internationalization.hpp"
 #include <vector>
 #include <map>
+#include <set>
+#include <iterator>
 #include <string>
 #include <stdexcept>
 
 namespace strus
 {
 
+/// \brief Forward declaration
+class BinaryImageWriter;
+/// \brief Forward declaration
+class BinaryImageReader;
+
 enum
 {
 	BaseAddrRuleTable =		(10000000 *  1),
@@ -82,22 +89,24 @@ struct EventTrigger
 	Trigger trigger;
 };
 
+/// \brief State of a rule updated by the signals fired
+/// \remark The record has a size of 32 bytes with the fields accessed on every signal at the start, so that firing a signal touches one cache line of the slot and not the rule. The result event and result handle are read from the program only on a match.
 struct ActionSlot
 {
 	uint32_t value;
-	uint32_t event;
+	uint32_t end_ordpos;
+	uint16_t count;
+	uint16_t done;
 	uint32_t rule;
-	uint32_t resultHandle;
+	uint32_t program;
 	uint32_t start_ordpos;
-	uint32_t end_ordpos;
 	uint32_t start_origseg;
 	uint32_t start_origpos;
-	uint16_t count;
 
-	ActionSlot( uint32_t value_, uint16_t count_, uint32_t event_, uint32_t rule_, uint32_t resultHandle_)
-		:value(value_),event(event_),rule(rule_),resultHandle(resultHandle_),start_ordpos(0),end_ordpos(0),start_origseg(0),start_origpos(0),count(count_){}
+	ActionSlot( uint32_t value_, uint16_t count_, uint32_t program_, uint32_t rule_)
+		:value(value_),end_ordpos(0),count(count_),done(0),rule(rule_),program(program_),start_ordpos(0),start_origseg(0),start_origpos(0){}
 	ActionSlot( const ActionSlot& o)
-		:value(o.value),event(o.event),rule(o.rule),resultHandle(o.resultHandle),start_ordpos(o.start_ordpos),end_ordpos(o.end_ordpos),start_origseg(o.start_origseg),start_origpos(o.start_origpos),count(o.count){}
+		:value(o.value),end_ordpos(o.end_ordpos),count(o.count),done(o.done),rule(o.rule),program(o.program),start_ordpos(o.start_ordpos),start_origseg(o.start_origseg),start_origpos(o.start_origpos){}
 };
 
 struct ActionSlotTableFreeListElem {uint32_t _;uint32_t next;};
@@ -140,6 +149,20 @@ public:
 
 	typedef PodStructArrayBase<Trigger const*,std::size_t,0> TriggerRefList;
 	void getTriggers( TriggerRefList& triggers, uint32_t event) const;
+
+	///\brief Kernel used for scanning the event array for triggers fired by an event
+	enum ScanKernel {ScanScalar=0,ScanSSE4=1,ScanAVX2=2,ScanAVX512=3};
+	enum {NofScanKernels=4};
+	static const char* scanKernelName( ScanKernel i)
+	{
+		static const char* ar[] = {"scalar","SSE4","AVX2","AVX-512"};
+		return ar[i];
+	}
+	///\brief Evaluate if a scan kernel is compiled in and supported by the CPU we are running on
+	static bool scanKernelSupported( ScanKernel kernel);
+	///\brief Get the triggers fired by an event with an explicitly chosen scan kernel
+	///\remark Used for testing the kernels against each other, getTriggers(TriggerRefList&,uint32_t) uses the best kernel available
+	void getTriggers( TriggerRefList& triggers, uint32_t event, ScanKernel kernel) const;
 	uint32_t nofTriggers() const			{return m_nofTriggers;}
 	void clear();
 
@@ -171,13 +194,12 @@ public:
 	uint32_t actionSlotIdx;
 	uint32_t eventTriggerListIdx;
 	uint32_t eventDataReferenceIdx;
-	unsigned int done:1;
-	unsigned int lastpos:31;
+	uint32_t lastpos;
 
 	explicit Rule( uint32_t lastpos_=0)
-		:actionSlotIdx(0),eventTriggerListIdx(0),eventDataReferenceIdx(0),done(0),lastpos(lastpos_){}
+		:actionSlotIdx(0),eventTriggerListIdx(0),eventDataReferenceIdx(0),lastpos(lastpos_){}
 	Rule( const Rule& o)
-		:actionSlotIdx(o.actionSlotIdx),eventTriggerListIdx(o.eventTriggerListIdx),eventDataReferenceIdx(o.eventDataReferenceIdx),done(o.done),lastpos(o.lastpos){}
+		:actionSlotIdx(o.actionSlotIdx),eventTriggerListIdx(o.eventTriggerListIdx),eventDataReferenceIdx(o.eventDataReferenceIdx),lastpos(o.lastpos){}
 
 	bool isActive() const	{return actionSlotIdx!=0;}
 };
@@ -334,6 +356,72 @@ struct ProgramTrigger
 
 struct ProgramTableFreeListElem {uint32_t _;uint32_t next;};
 
+struct KeyEventEntry
+{
+	uint32_t event;			///< key event or 0 for an empty slot
+	uint32_t programlist;		///< list of programs triggered by the event (index in the program trigger list) or 0
+	uint32_t stopword;		///< index of the stop word (1,2,...) in a dense enumeration of all stop words, 0 if the event is not a stop word
+
+	KeyEventEntry()
+		:event(0),programlist(0),stopword(0){}
+	KeyEventEntry( uint32_t event_, uint32_t programlist_, uint32_t stopword_)
+		:event(event_),programlist(programlist_),stopword(stopword_){}
+	KeyEventEntry( const KeyEventEntry& o)
+		:event(o.event),programlist(o.programlist),stopword(o.stopword){}
+};
+
+/// \brief Hash table with linear probing of the key events and stop words as one flat array
+/// \note Contains no pointers, so that it can be used in place, e.g. in a binary image mapped read only into the memory of several processes
+class KeyEventTable
+{
+public:
+	KeyEventTable()
+		:m_ownar(),m_ar(0),m_size(0),m_nofStopWords(0){}
+
+	/// \brief Build the table
+	/// \param[in] entries list of the key events (event identifiers are unique and not 0, stop word indices are unique and dense)
+	void build( const std::vector<KeyEventEntry>& entries);
+	/// \brief Use an array not owned as table
+	/// \param[in] ar pointer to the table
+	/// \param[in] size size of the table, either 0 or a power of two
+	void attach( const KeyEventEntry* ar, uint32_t size);
+	void clear();
+	/// \brief Exchange the content with another table without copying the entries
+	void swap( KeyEventTable& o);
+
+	const KeyEventEntry* find( uint32_t event) const
+	{
+		if (!m_size) return 0;
+		uint32_t mask = m_size-1;
+		uint32_t idx = hash( event) & mask;
+		for (;;)
+		{
+			const KeyEventEntry* entry = m_ar + idx;
+			if (entry->event == event) return entry;
+			if (entry->event == 0) return 0;
+			idx = (idx + 1) & mask;
+		}
+	}
+
+	const KeyEventEntry* data() const	{return m_ar;}
+	uint32_t size() const			{return m_size;}
+	uint32_t nofStopWords() const		{return m_nofStopWords;}
+
+private:
+	static uint32_t hash( uint32_t event)
+	{
+		uint32_t hh = event ^ (event >> 16);
+		hh *= 0x45d9f3b;
+		return hh ^ (hh >> 16);
+	}
+
+private:
+	std::vector<KeyEventEntry> m_ownar;
+	const KeyEventEntry* m_ar;
+	uint32_t m_size;
+	uint32_t m_nofStopWords;
+};
+
 class ProgramTable
 {
 public:
@@ -354,7 +442,16 @@ public:
 
 	void defineProgramResult( uint32_t programidx, uint32_t eventid, uint32_t resultHandle);
 
-	uint32_t getEventProgramList( uint32_t eventid) const;
+	uint32_t getEventProgramList( uint32_t eventid) const
+	{
+		if (m_keyEventTable.size())
+		{
+			const KeyEventEntry* entry = m_keyEventTable.find( eventid);
+			return entry ? entry->programlist : 0;
+		}
+		EventProgamTriggerMap::const_iterator ei = m_eventProgamTriggerMap.find( eventid);
+		return ei == m_eventProgamTriggerMap.end() ? 0:ei->second;
+	}
 	const ProgramTrigger* nextProgramPtr( uint32_t& programlist) const;
 
 	struct OptimizeOptions
@@ -370,6 +467,10 @@ public:
 	};
 	void optimize( OptimizeOptions& opt);
 
+	/// \brief Remove all programs that can never be triggered and the key events that can never occur
+	/// \param[in] termEvents set of all term events that can occur in the input
+	void eliminateUnreachablePrograms( const std::set<uint32_t>& termEvents);
+
 	struct Statistics
 	{
 		std::vector<uint32_t> keyEventDist;
@@ -377,7 +478,37 @@ public:
 	};
 
 	Statistics getProgramStatistics() const;
-	bool isStopWord( uint32_t eventid) const		{return m_stopWordSet.find(eventid) != m_stopWordSet.end();}
+	/// \brief Get all events triggering a program that can be activated by a key event
+	void getTriggerEvents( std::set<uint32_t>& res) const;
+	/// \brief Get an upper bound for the distance in ordinal positions between the start of a result and any event the result depends on
+	/// \return the bound or std::numeric_limits<uint32_t>::max() if there is none (e.g. for recursive patterns)
+	uint32_t getMaxResultReach() const;
+	/// \brief Get the index of a stop word in a dense enumeration (1,2,...) of all stop words
+	/// \remark Stop words are only defined by optimize, that builds the key event table, or imported with the key event table of an image. The key event table is therefore the only source of stop word indices used by the matcher.
+	/// \return the index or 0 if the event is not a stop word
+	uint32_t stopWordIndex( uint32_t eventid) const
+	{
+		const KeyEventEntry* entry = m_keyEventTable.find( eventid);
+		return entry ? entry->stopword : 0;
+	}
+	/// \brief Get the number of stop words, the upper bound of stopWordIndex
+	uint32_t nofStopWords() const
+	{
+		return m_keyEventTable.nofStopWords();
+	}
+	bool isStopWord( uint32_t eventid) const
+	{
+		return stopWordIndex( eventid) != 0;
+	}
+
+	/// \brief Write the tables needed for matching (after optimize) to a binary image
+	/// \note The image contains only arrays with indices and no pointers, the read path of the matcher uses it in place without building any maps
+	void exportImage( BinaryImageWriter& writer) const;
+	/// \brief Use the tables of a binary image written with exportImage, the arrays of the image are referenced and not copied
+	/// \remark The image has to stay valid as long as this table is used, the table must not be modified afterwards
+	void importImage( BinaryImageReader& reader);
+	/// \brief Exchange the content with another table without copying it
+	void swap( ProgramTable& o);
 
 private:
 	void defineEventProgramAlt( uint32_t eventid, uint32_t programidx, uint32_t past_eventid);
@@ -387,16 +518,23 @@ private:
 	void defineEventProgram( uint32_t eventid, uint32_t programidx);
 	void defineDisposeRule( uint32_t pos, uint32_t ruleidx);
 	void eliminateUnusedEvents();
+	bool isProgramReachable( const Program& program, const std::set<uint32_t>& possibleEvents) const;
+	void buildKeyEventTable( KeyEventTable& res) const;
+	/// \brief Update the key event table after a change of the key events outside of optimize
+	void keyEventsChanged();
+	void getKeyEventProgramLists( std::vector<std::pair<uint32_t,uint32_t> >& res) const;
 
 private:
 	ActionSlotDefList m_actionSlotArray;
 	TriggerDefList m_triggerList;
 	typedef PodStructTableBase<Program,uint32_t,ProgramTableFreeListElem,BaseAddrProgramTable> ProgramMap;
 	ProgramMap m_programMap;
-	PodStackPoolBase<ProgramTrigger,uint32_t,BaseAddrProgramList> m_programTriggerList;
+	typedef PodStackPoolBase<ProgramTrigger,uint32_t,BaseAddrProgramList> ProgramTriggerList;
+	ProgramTriggerList m_programTriggerList;
 	typedef utils::UnorderedMap<uint32_t,uint32_t> EventProgamTriggerMap;
 	EventProgamTriggerMap m_eventProgamTriggerMap;
 	std::set<uint32_t> m_stopWordSet;
+	KeyEventTable m_keyEventTable;		///< flat table of m_eventProgamTriggerMap and m_stopWordSet used by the matcher, built by optimize or attached to an image
 	typedef std::map<uint32_t,uint32_t> EventOccurrenceMap;
 	EventOccurrenceMap m_keyOccurrenceMap;
 	EventOccurrenceMap m_eventOccurrenceMap;
@@ -410,15 +548,12 @@ struct DisposeEvent
 	uint32_t pos;
 	uint32_t idx;
 
+	DisposeEvent()
+		:pos(0),idx(0){}
 	DisposeEvent( uint32_t pos_, uint32_t idx_)
 		:pos(pos_),idx(idx_){}
 	DisposeEvent( const DisposeEvent& o)
 		:pos(o.pos),idx(o.idx){}
-
-	bool operator<( const DisposeEvent& o) const
-	{
-		return pos > o.pos;
-	}
 };
 
 class StateMachine
@@ -446,6 +581,10 @@ public:
 	{
 		return m_eventItemList.nextptr( list);
 	}
+	/// \brief Sort the results from an index on by their position and pattern
+	/// \remark Used to get the results issued by one input event in an order that does not depend on the history of the trigger tables
+	void sortResults( std::size_t startidx);
+	/// \brief Reset the state for a new document, the memory allocated by the tables is kept for reuse
 	void clear();
 
 public://getStatistics
@@ -467,9 +606,12 @@ private:
 	void appendEventData( uint32_t eventdataref, const EventItem& item);
 	void joinEventData( uint32_t eventdataref_dest, uint32_t eventdataref_src);
 	void replayPastEvent( uint32_t eventid, const Rule& rule, uint32_t positionRange);
+	const EventLog* getStopWordEventLog( uint32_t eventid) const;
 	void installProgram( uint32_t keyevent, const ProgramTrigger& programTrigger, const EventData& data, EventStructList& followList, DisposeRuleList& disposeRuleList);
 	void installEventPrograms( uint32_t keyevent, const EventData& data, EventStructList& followList, DisposeRuleList& disposeRuleList);
 	void defineDisposeRule( uint32_t pos, uint32_t ruleidx);
+	void insertDisposeEvent( const DisposeEvent& ev);
+	unsigned int disposeWheelSlots( unsigned int level, uint64_t slotmask);
 
 private:
 	const ProgramTable* m_programTable;
@@ -481,12 +623,13 @@ private:
 	RuleTable m_ruleTable;
 	ResultList m_results;
 	uint32_t m_curpos;
-	enum {DisposeWindowSize=64};
-	uint32_t m_disposeWindow[ DisposeWindowSize];
-	typedef PodStackPoolBase<uint32_t,uint32_t,BaseAddrDisposeEventList> DisposeEventList;
+	/// \brief Hierarchical timing wheel of rules to dispose: an event at position pos is stored on the level of the highest group of DisposeWheelLevelBits bits where pos differs from m_curpos, in the slot addressed by this group of pos
+	enum {DisposeWheelLevelBits=6, DisposeWheelSlots=(1<<DisposeWheelLevelBits), DisposeWheelLevels=((32+DisposeWheelLevelBits-1)/DisposeWheelLevelBits)};
+	uint32_t m_disposeWheel[ DisposeWheelLevels][ DisposeWheelSlots];
+	uint64_t m_disposeWheelOccupied[ DisposeWheelLevels];	///< bit mask of non empty slots per level of the timing wheel
+	typedef PodStackPoolBase<DisposeEvent,uint32_t,BaseAddrDisposeEventList> DisposeEventList;
 	DisposeEventList m_disposeRuleList;
-	std::vector<DisposeEvent> m_ruleDisposeQueue;
-	std::map<uint32_t,EventLog> m_stopWordsEventLogMap;
+	std::vector<EventLog> m_stopWordsEventLogAr;		///< last occurrence of every stop word, indexed by ProgramTable::stopWordIndex - 1, timestmp 0 for none
 	unsigned int m_nofProgramsInstalled;
 	unsigned int m_nofAltKeyProgramsInstalled;
 	unsigned int m_nofSignalsFired;
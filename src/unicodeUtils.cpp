@@ -13,6 +13,11 @@
 #include "textwolf/cstringiterator.hpp"
 #include "textwolf/staticbuffer.hpp"
 #include "internationalization.hpp"
+#include "strus/base/stdint.h"
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace strus;
 
@@ -43,6 +48,355 @@ void OneByteCharMap::init( const char* src, std::size_t srcsize)
 	}
 }
 
+namespace {
+/// \brief Run of characters with a simple case folding, every stride'th character of [first,last] is mapped to the character + delta
+struct CaseFoldRun
+{
+	unsigned int first;
+	unsigned int last;
+	int delta;
+	unsigned int stride;
+};
+}//anonymous namespace
+
+/// \brief Simple case folding (status C and S) of CaseFolding.txt of the Unicode Character Database 14.0.0, compressed to runs sorted by first character
+static const CaseFoldRun g_caseFoldRuns[] =
+{
+	{0x0041,0x005A,32,1},{0x00B5,0x00B5,775,1},{0x00C0,0x00D6,32,1},{0x00D8,0x00DE,32,1},{0x0100,0x012E,1,2},{0x0132,0x0136,1,2},
+	{0x0139,0x0147,1,2},{0x014A,0x0176,1,2},{0x0178,0x0178,-121,1},{0x0179,0x017D,1,2},{0x017F,0x017F,-268,1},{0x0181,0x0181,210,1},
+	{0x0182,0x0184,1,2},{0x0186,0x0186,206,1},{0x0187,0x0187,1,1},{0x0189,0x018A,205,1},{0x018B,0x018B,1,1},{0x018E,0x018E,79,1},
+	{0x018F,0x018F,202,1},{0x0190,0x0190,203,1},{0x0191,0x0191,1,1},{0x0193,0x0193,205,1},{0x0194,0x0194,207,1},{0x0196,0x0196,211,1},
+	{0x0197,0x0197,209,1},{0x0198,0x0198,1,1},{0x019C,0x019C,211,1},{0x019D,0x019D,213,1},{0x019F,0x019F,214,1},{0x01A0,0x01A4,1,2},
+	{0x01A6,0x01A6,218,1},{0x01A7,0x01A7,1,1},{0x01A9,0x01A9,218,1},{0x01AC,0x01AC,1,1},{0x01AE,0x01AE,218,1},{0x01AF,0x01AF,1,1},
+	{0x01B1,0x01B2,217,1},{0x01B3,0x01B5,1,2},{0x01B7,0x01B7,219,1},{0x01B8,0x01B8,1,1},{0x01BC,0x01BC,1,1},{0x01C4,0x01C4,2,1},
+	{0x01C5,0x01C5,1,1},{0x01C7,0x01C7,2,1},{0x01C8,0x01C8,1,1},{0x01CA,0x01CA,2,1},{0x01CB,0x01DB,1,2},{0x01DE,0x01EE,1,2},
+	{0x01F1,0x01F1,2,1},{0x01F2,0x01F4,1,2},{0x01F6,0x01F6,-97,1},{0x01F7,0x01F7,-56,1},{0x01F8,0x021E,1,2},{0x0220,0x0220,-130,1},
+	{0x0222,0x0232,1,2},{0x023A,0x023A,10795,1},{0x023B,0x023B,1,1},{0x023D,0x023D,-163,1},{0x023E,0x023E,10792,1},{0x0241,0x0241,1,1},
+	{0x0243,0x0243,-195,1},{0x0244,0x0244,69,1},{0x0245,0x0245,71,1},{0x0246,0x024E,1,2},{0x0345,0x0345,116,1},{0x0370,0x0372,1,2},
+	{0x0376,0x0376,1,1},{0x037F,0x037F,116,1},{0x0386,0x0386,38,1},{0x0388,0x038A,37,1},{0x038C,0x038C,64,1},{0x038E,0x038F,63,1},
+	{0x0391,0x03A1,32,1},{0x03A3,0x03AB,32,1},{0x03C2,0x03C2,1,1},{0x03CF,0x03CF,8,1},{0x03D0,0x03D0,-30,1},{0x03D1,0x03D1,-25,1},
+	{0x03D5,0x03D5,-15,1},{0x03D6,0x03D6,-22,1},{0x03D8,0x03EE,1,2},{0x03F0,0x03F0,-54,1},{0x03F1,0x03F1,-48,1},{0x03F4,0x03F4,-60,1},
+	{0x03F5,0x03F5,-64,1},{0x03F7,0x03F7,1,1},{0x03F9,0x03F9,-7,1},{0x03FA,0x03FA,1,1},{0x03FD,0x03FF,-130,1},{0x0400,0x040F,80,1},
+	{0x0410,0x042F,32,1},{0x0460,0x0480,1,2},{0x048A,0x04BE,1,2},{0x04C0,0x04C0,15,1},{0x04C1,0x04CD,1,2},{0x04D0,0x052E,1,2},
+	{0x0531,0x0556,48,1},{0x10A0,0x10C5,7264,1},{0x10C7,0x10C7,7264,1},{0x10CD,0x10CD,7264,1},{0x13F8,0x13FD,-8,1},{0x1C80,0x1C80,-6222,1},
+	{0x1C81,0x1C81,-6221,1},{0x1C82,0x1C82,-6212,1},{0x1C83,0x1C84,-6210,1},{0x1C85,0x1C85,-6211,1},{0x1C86,0x1C86,-6204,1},{0x1C87,0x1C87,-6180,1},
+	{0x1C88,0x1C88,35267,1},{0x1C90,0x1CBA,-3008,1},{0x1CBD,0x1CBF,-3008,1},{0x1E00,0x1E94,1,2},{0x1E9B,0x1E9B,-58,1},{0x1E9E,0x1E9E,-7615,1},
+	{0x1EA0,0x1EFE,1,2},{0x1F08,0x1F0F,-8,1},{0x1F18,0x1F1D,-8,1},{0x1F28,0x1F2F,-8,1},{0x1F38,0x1F3F,-8,1},{0x1F48,0x1F4D,-8,1},
+	{0x1F59,0x1F5F,-8,2},{0x1F68,0x1F6F,-8,1},{0x1F88,0x1F8F,-8,1},{0x1F98,0x1F9F,-8,1},{0x1FA8,0x1FAF,-8,1},{0x1FB8,0x1FB9,-8,1},
+	{0x1FBA,0x1FBB,-74,1},{0x1FBC,0x1FBC,-9,1},{0x1FBE,0x1FBE,-7173,1},{0x1FC8,0x1FCB,-86,1},{0x1FCC,0x1FCC,-9,1},{0x1FD8,0x1FD9,-8,1},
+	{0x1FDA,0x1FDB,-100,1},{0x1FE8,0x1FE9,-8,1},{0x1FEA,0x1FEB,-112,1},{0x1FEC,0x1FEC,-7,1},{0x1FF8,0x1FF9,-128,1},{0x1FFA,0x1FFB,-126,1},
+	{0x1FFC,0x1FFC,-9,1},{0x2126,0x2126,-7517,1},{0x212A,0x212A,-8383,1},{0x212B,0x212B,-8262,1},{0x2132,0x2132,28,1},{0x2160,0x216F,16,1},
+	{0x2183,0x2183,1,1},{0x24B6,0x24CF,26,1},{0x2C00,0x2C2F,48,1},{0x2C60,0x2C60,1,1},{0x2C62,0x2C62,-10743,1},{0x2C63,0x2C63,-3814,1},
+	{0x2C64,0x2C64,-10727,1},{0x2C67,0x2C6B,1,2},{0x2C6D,0x2C6D,-10780,1},{0x2C6E,0x2C6E,-10749,1},{0x2C6F,0x2C6F,-10783,1},{0x2C70,0x2C70,-10782,1},
+	{0x2C72,0x2C72,1,1},{0x2C75,0x2C75,1,1},{0x2C7E,0x2C7F,-10815,1},{0x2C80,0x2CE2,1,2},{0x2CEB,0x2CED,1,2},{0x2CF2,0x2CF2,1,1},
+	{0xA640,0xA66C,1,2},{0xA680,0xA69A,1,2},{0xA722,0xA72E,1,2},{0xA732,0xA76E,1,2},{0xA779,0xA77B,1,2},{0xA77D,0xA77D,-35332,1},
+	{0xA77E,0xA786,1,2},{0xA78B,0xA78B,1,1},{0xA78D,0xA78D,-42280,1},{0xA790,0xA792,1,2},{0xA796,0xA7A8,1,2},{0xA7AA,0xA7AA,-42308,1},
+	{0xA7AB,0xA7AB,-42319,1},{0xA7AC,0xA7AC,-42315,1},{0xA7AD,0xA7AD,-42305,1},{0xA7AE,0xA7AE,-42308,1},{0xA7B0,0xA7B0,-42258,1},{0xA7B1,0xA7B1,-42282,1},
+	{0xA7B2,0xA7B2,-42261,1},{0xA7B3,0xA7B3,928,1},{0xA7B4,0xA7C2,1,2},{0xA7C4,0xA7C4,-48,1},{0xA7C5,0xA7C5,-42307,1},{0xA7C6,0xA7C6,-35384,1},
+	{0xA7C7,0xA7C9,1,2},{0xA7D0,0xA7D0,1,1},{0xA7D6,0xA7D8,1,2},{0xA7F5,0xA7F5,1,1},{0xAB70,0xABBF,-38864,1},{0xFF21,0xFF3A,32,1},
+	{0x10400,0x10427,40,1},{0x104B0,0x104D3,40,1},{0x10570,0x1057A,39,1},{0x1057C,0x1058A,39,1},{0x1058C,0x10592,39,1},{0x10594,0x10595,39,1},
+	{0x10C80,0x10CB2,64,1},{0x118A0,0x118BF,32,1},{0x16E40,0x16E5F,32,1},{0x1E900,0x1E921,34,1},
+};
+
+static const int g_nofCaseFoldRuns = sizeof(g_caseFoldRuns) / sizeof(g_caseFoldRuns[0]);
+
+/// \brief Get the index of the last run starting at or before a character or -1 if there is none
+static int findCaseFoldRun( unsigned int chr)
+{
+	int lo = 0, hi = g_nofCaseFoldRuns;
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (g_caseFoldRuns[ mid].first <= chr)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return lo - 1;
+}
+
+unsigned int strus::foldCaseChar( unsigned int chr)
+{
+	if (chr < 128)
+	{
+		return (chr >= 'A' && chr <= 'Z') ? (chr + 32) : chr;
+	}
+	int ri = findCaseFoldRun( chr);
+	if (ri >= 0)
+	{
+		const CaseFoldRun& run = g_caseFoldRuns[ ri];
+		if (chr <= run.last && (chr - run.first) % run.stride == 0)
+		{
+			return chr + run.delta;
+		}
+	}
+	return chr;
+}
+
+FoldCaseRangeClass strus::foldCaseRange( unsigned int first, unsigned int last, int& delta)
+{
+	std::size_t nofFolded = 0;
+	bool uniform = true;
+	delta = 0;
+	int ri = findCaseFoldRun( first);
+	if (ri < 0) ri = 0;
+	for (; ri < g_nofCaseFoldRuns && g_caseFoldRuns[ ri].first <= last; ++ri)
+	{
+		const CaseFoldRun& run = g_caseFoldRuns[ ri];
+		unsigned int lo = first > run.first ? first : run.first;
+		unsigned int hi = last < run.last ? last : run.last;
+		if (lo > hi) continue;
+		unsigned int rest = (lo - run.first) % run.stride;
+		if (rest) lo += run.stride - rest;
+		if (lo > hi) continue;
+
+		nofFolded += (hi - lo) / run.stride + 1;
+		if (delta == 0)
+		{
+			delta = run.delta;
+		}
+		else if (delta != run.delta)
+		{
+			uniform = false;
+		}
+	}
+	if (nofFolded == 0)
+	{
+		return FoldCaseRangeUnchanged;
+	}
+	if (uniform && nofFolded == (std::size_t)(last - first) + 1)
+	{
+		return FoldCaseRangeShifted;
+	}
+	return FoldCaseRangeMixed;
+}
+
+unsigned int strus::utf8decode( const char* src, std::size_t srcsize, std::size_t& chrsize)
+{
+	const unsigned char* ui = (const unsigned char*)src;
+	unsigned int chr;
+	unsigned int minchr;
+	chrsize = 0;
+	if (srcsize == 0) return 0;
+	if (ui[0] < 0x80)
+	{
+		chrsize = 1;
+		return ui[0];
+	}
+	else if ((ui[0] & 0xE0) == 0xC0)
+	{
+		chrsize = 2;
+		chr = ui[0] & 0x1F;
+		minchr = 0x80;
+	}
+	else if ((ui[0] & 0xF0) == 0xE0)
+	{
+		chrsize = 3;
+		chr = ui[0] & 0x0F;
+		minchr = 0x800;
+	}
+	else if ((ui[0] & 0xF8) == 0xF0)
+	{
+		chrsize = 4;
+		chr = ui[0] & 0x07;
+		minchr = 0x10000;
+	}
+	else
+	{
+		return 0;
+	}
+	if (chrsize > srcsize)
+	{
+		chrsize = 0;
+		return 0;
+	}
+	std::size_t ci = 1;
+	for (; ci < chrsize; ++ci)
+	{
+		if ((ui[ ci] & 0xC0) != 0x80)
+		{
+			chrsize = 0;
+			return 0;
+		}
+		chr = (chr << 6) | (ui[ ci] & 0x3F);
+	}
+	if (chr < minchr || chr > 0x10FFFF)
+	{
+		chrsize = 0;
+		return 0;
+	}
+	return chr;
+}
+
+/// \brief Write the UTF-8 encoding of a unicode character to a buffer of at least 4 bytes
+/// \return the size of the encoding in bytes
+static std::size_t utf8encode( char* buf, unsigned int chr)
+{
+	if (chr < 0x80)
+	{
+		buf[0] = (char)chr;
+		return 1;
+	}
+	else if (chr < 0x800)
+	{
+		buf[0] = (char)(unsigned char)(0xC0 | (chr >> 6));
+		buf[1] = (char)(unsigned char)(0x80 | (chr & 0x3F));
+		return 2;
+	}
+	else if (chr < 0x10000)
+	{
+		buf[0] = (char)(unsigned char)(0xE0 | (chr >> 12));
+		buf[1] = (char)(unsigned char)(0x80 | ((chr >> 6) & 0x3F));
+		buf[2] = (char)(unsigned char)(0x80 | (chr & 0x3F));
+		return 3;
+	}
+	else
+	{
+		buf[0] = (char)(unsigned char)(0xF0 | (chr >> 18));
+		buf[1] = (char)(unsigned char)(0x80 | ((chr >> 12) & 0x3F));
+		buf[2] = (char)(unsigned char)(0x80 | ((chr >> 6) & 0x3F));
+		buf[3] = (char)(unsigned char)(0x80 | (chr & 0x3F));
+		return 4;
+	}
+}
+
+void strus::utf8append( std::string& dest, unsigned int chr)
+{
+	char buf[ 4];
+	dest.append( buf, utf8encode( buf, chr));
+}
+
+/// \brief Fold the ASCII characters of a string in blocks as long as the blocks contain only ASCII characters
+/// \return the number of bytes folded
+static std::size_t foldAsciiBlocks( char* dest, const char* src, std::size_t srcsize)
+{
+	std::size_t pi = 0;
+#if defined(__SSE2__)
+	// Fold 16 characters per iteration, 0x20 is added to the bytes greater than 'A'-1 and less than 'Z'+1:
+	const __m128i above = _mm_set1_epi8( 'A' - 1);
+	const __m128i below = _mm_set1_epi8( 'Z' + 1);
+	const __m128i diff = _mm_set1_epi8( 0x20);
+	for (; pi + 16 <= srcsize; pi += 16)
+	{
+		__m128i vv = _mm_loadu_si128( (const __m128i*)(src + pi));
+		if (_mm_movemask_epi8( vv) != 0) return pi;
+		__m128i isupper = _mm_and_si128( _mm_cmpgt_epi8( vv, above), _mm_cmplt_epi8( vv, below));
+		_mm_storeu_si128( (__m128i*)(dest + pi), _mm_add_epi8( vv, _mm_and_si128( isupper, diff)));
+	}
+#endif
+	static const uint64_t ones = ~(uint64_t)0 / 0xFF;
+	static const uint64_t highbits = ones * 0x80;
+	for (; pi + sizeof(uint64_t) <= srcsize; pi += sizeof(uint64_t))
+	{
+		// Fold 8 characters at once: the high bit of a byte in ge_A is set if the byte is >= 'A', in gt_Z if it is > 'Z':
+		uint64_t word;
+		std::memcpy( &word, src + pi, sizeof(word));
+		if ((word & highbits) != 0) return pi;
+		uint64_t ge_A = word + ones * (0x80 - 'A');
+		uint64_t gt_Z = word + ones * (0x80 - 'Z' - 1);
+		word |= ((ge_A ^ gt_Z) & highbits) >> 2;
+		std::memcpy( dest + pi, &word, sizeof(word));
+	}
+	return pi;
+}
+
+void FoldCaseMap::init( const char* src, std::size_t srcsize)
+{
+	posar.clear();
+	// ... the UTF-8 encoding of a folded character is at most 3/2 of the size of the original:
+	value.resize( srcsize + srcsize / 2 + 4);
+	char* dest = &value[0];
+	std::size_t pi = 0;
+	std::size_t di = 0;
+	bool mapped = false;
+	char chrbuf[ 4];
+
+	while (pi < srcsize)
+	{
+		std::size_t blksize = foldAsciiBlocks( dest + di, src + pi, srcsize - pi);
+		if (blksize)
+		{
+			if (mapped)
+			{
+				for (std::size_t bi=0; bi < blksize; ++bi) posar.push_back( pi + bi);
+			}
+			pi += blksize;
+			di += blksize;
+			continue;
+		}
+		std::size_t chrsize;
+		unsigned int chr = utf8decode( src + pi, srcsize - pi, chrsize);
+		std::size_t foldsize = chrsize;
+		const char* fold = src + pi;
+		if (chrsize == 0)
+		{
+			//... invalid bytes are copied as they are
+			foldsize = chrsize = 1;
+		}
+		else
+		{
+			unsigned int fc = foldCaseChar( chr);
+			if (fc != chr)
+			{
+				foldsize = utf8encode( chrbuf, fc);
+				fold = chrbuf;
+			}
+		}
+		if (foldsize != chrsize && !mapped)
+		{
+			//... first change of an encoding size, the positions up to here are the same in both strings
+			mapped = true;
+			posar.reserve( value.size() + 1);
+			for (std::size_t ii=0; ii < di; ++ii) posar.push_back( ii);
+		}
+		std::memcpy( dest + di, fold, foldsize);
+		if (mapped)
+		{
+			for (std::size_t ii=0; ii < foldsize; ++ii) posar.push_back( pi);
+		}
+		pi += chrsize;
+		di += foldsize;
+	}
+	value.resize( di);
+	if (mapped)
+	{
+		posar.push_back( srcsize);
+	}
+}
+
+bool strus::isAsciiString( const char* src, std::size_t srcsize)
+{
+	std::size_t pi = 0;
+#if defined(__SSE2__)
+	// Test 64 bytes per iteration, the sign bits of the or-ed blocks are collected with one movemask:
+	for (; pi + 64 <= srcsize; pi += 64)
+	{
+		__m128i v0 = _mm_loadu_si128( (const __m128i*)(src + pi));
+		__m128i v1 = _mm_loadu_si128( (const __m128i*)(src + pi + 16));
+		__m128i v2 = _mm_loadu_si128( (const __m128i*)(src + pi + 32));
+		__m128i v3 = _mm_loadu_si128( (const __m128i*)(src + pi + 48));
+		__m128i vv = _mm_or_si128( _mm_or_si128( v0, v1), _mm_or_si128( v2, v3));
+		if (_mm_movemask_epi8( vv) != 0) return false;
+	}
+#endif
+	static const uint64_t highbits = (~(uint64_t)0 / 0xFF) * 0x80;
+	for (; pi + sizeof(uint64_t) <= srcsize; pi += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy( &word, src + pi, sizeof(word));
+		if ((word & highbits) != 0) return false;
+	}
+	for (; pi < srcsize; ++pi)
+	{
+		if ((unsigned char)src[ pi] >= 128) return false;
+	}
+	return true;
+}
+
 template <class CharSet>
 static void printString( const CharSet& charset, textwolf::StaticBuffer& outbuf, std::size_t* posar, const char* src, std::size_t srcsize, int sizeofwchar)
 {
@@ -27,6 +27,69 @@ public:
 	std::vector<std::size_t> posar;
 };
 
+/// \brief Get the simple case folding of a unicode character
+/// \remark The mapping is the simple case folding (status C and S) of the Unicode Character Database (CaseFolding.txt)
+/// \param[in] chr unicode character
+/// \return the folded character or chr, if it has no case folding
+unsigned int foldCaseChar( unsigned int chr);
+
+/// \brief Classification of a range of unicode characters by the way they are mapped by the simple case folding
+enum FoldCaseRangeClass
+{
+	FoldCaseRangeUnchanged,		///< no character of the range is mapped to another character
+	FoldCaseRangeShifted,		///< all characters of the range are mapped to the character with the same offset
+	FoldCaseRangeMixed		///< some characters of the range are mapped, some not or with different offsets
+};
+
+/// \brief Classify a range of unicode characters by the way they are mapped by the simple case folding
+/// \param[in] first first character of the range
+/// \param[in] last last character of the range
+/// \param[out] delta offset added to each character of the range by the case folding, if the range is classified as FoldCaseRangeShifted
+/// \return the classification of the range
+FoldCaseRangeClass foldCaseRange( unsigned int first, unsigned int last, int& delta);
+
+/// \brief Decode one UTF-8 encoded character
+/// \param[in] src pointer to the UTF-8 encoding of the character
+/// \param[in] srcsize number of bytes available in src
+/// \param[out] chrsize size of the encoding of the character in bytes or 0 if src does not start with a valid and complete UTF-8 encoding
+/// \return the unicode character or 0 if chrsize is 0
+unsigned int utf8decode( const char* src, std::size_t srcsize, std::size_t& chrsize);
+
+/// \brief Append the UTF-8 encoding of a unicode character to a string
+/// \param[in,out] dest where to append the encoding
+/// \param[in] chr unicode character
+void utf8append( std::string& dest, unsigned int chr);
+
+/// \brief Simple case folding of a UTF-8 string with a map of the byte positions of the folded string to the byte positions of the original string
+class FoldCaseMap
+{
+public:
+	FoldCaseMap()
+		:value(),posar(){}
+
+	/// \brief Fold a UTF-8 string
+	/// \param[in] src the string to fold
+	/// \param[in] srcsize size of src in bytes
+	void init( const char* src, std::size_t srcsize);
+
+	/// \brief Get the byte position in the original string of a byte position in the folded string
+	/// \param[in] pos byte position in the folded string, value.size() for the end of the string
+	std::size_t origpos( std::size_t pos) const
+	{
+		return posar.empty() ? pos : posar[ pos];
+	}
+
+	std::string value;
+	/// \brief Byte positions in the original string of the bytes of the folded string plus the end of the original string, empty if no character folded changed the size of its UTF-8 encoding
+	std::vector<std::size_t> posar;
+};
+
+/// \brief Test if a string contains only ASCII characters (no byte with the high bit set)
+/// \param[in] src the string to test
+/// \param[in] srcsize size of src in bytes
+/// \return true, if all characters are ASCII
+bool isAsciiString( const char* src, std::size_t srcsize);
+
 struct WCharString
 {
 public:
@@ -11,6 +11,13 @@
 #include <boost/algorithm/string.hpp>
 #include <unistd.h>
 #include <stdlib.h>
+#include <cerrno>
+#include <cstring>
+#if !(defined _MSC_VER)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
 
 using namespace strus;
 using namespace strus::utils;
@@ -91,3 +98,44 @@ void utils::aligned_free( void *ptr)
 #endif
 }
 
+const char* utils::mapFileReadOnly( const std::string& path, std::size_t& size)
+{
+#if (defined _MSC_VER)
+	throw strus::runtime_error( _TXT( "mapping files into memory not implemented on this platform"));
+#else
+	int fd = ::open( path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw strus::runtime_error( _TXT( "failed to open file '%s': %s"), path.c_str(), ::strerror( errno));
+	}
+	struct stat st;
+	if (0!=::fstat( fd, &st))
+	{
+		int ec = errno;
+		::close( fd);
+		throw strus::runtime_error( _TXT( "failed to get the size of file '%s': %s"), path.c_str(), ::strerror( ec));
+	}
+	size = (std::size_t)st.st_size;
+	if (size == 0)
+	{
+		::close( fd);
+		throw strus::runtime_error( _TXT( "failed to map file '%s': %s"), path.c_str(), _TXT("file is empty"));
+	}
+	void* rt = ::mmap( 0, size, PROT_READ, MAP_SHARED, fd, 0);
+	int ec = errno;
+	::close( fd);
+	if (rt == MAP_FAILED)
+	{
+		throw strus::runtime_error( _TXT( "failed to map file '%s': %s"), path.c_str(), ::strerror( ec));
+	}
+	return (const char*)rt;
+#endif
+}
+
+void utils::unmapFile( const char* ptr, std::size_t size)
+{
+#if !(defined _MSC_VER)
+	if (ptr) ::munmap( (void*)const_cast<char*>( ptr), size);
+#endif
+}
+
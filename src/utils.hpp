@@ -10,6 +10,7 @@
 #define _STRUS_UTILS_HPP_INCLUDED
 #include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
+#include <boost/thread.hpp>
 
 namespace strus {
 namespace utils {
@@ -25,6 +26,14 @@ std::string tostring( int val);
 void aligned_free( void *ptr);
 void* aligned_malloc( std::size_t size, std::size_t alignment);
 
+/// \brief Map a file read only and shared into memory, the pages are shared with all other processes mapping the same file
+/// \param[in] path path of the file to map
+/// \param[out] size size of the file in bytes
+/// \return pointer to the mapping, aligned to a page boundary
+const char* mapFileReadOnly( const std::string& path, std::size_t& size);
+/// \brief Release a mapping created with mapFileReadOnly
+void unmapFile( const char* ptr, std::size_t size);
+
 template<typename Key, typename Elem>
 class UnorderedMap
 	:public boost::unordered_map<Key,Elem>
@@ -48,6 +57,50 @@ public:
 		:boost::shared_ptr<X>(){}
 };
 
+/// \brief Group of threads that joins all threads started in its destructor
+/// \remark Threads started before an exception thrown in the creating scope (e.g. by create_thread) must not outlive the data they work on, a boost::thread_group would detach them
+class ThreadGroup
+{
+public:
+	ThreadGroup(){}
+	~ThreadGroup()
+	{
+		try
+		{
+			m_threads.join_all();
+		}
+		catch (...){}
+	}
+
+	template <class Function>
+	void create_thread( Function func)
+	{
+		m_threads.create_thread( func);
+	}
+
+	void join_all()
+	{
+		m_threads.join_all();
+	}
+
+private:
+	ThreadGroup( const ThreadGroup&){}	//... non copyable
+	void operator=( const ThreadGroup&){}	//... non copyable
+
+private:
+	boost::thread_group m_threads;
+};
+
+typedef boost::mutex Mutex;
+typedef boost::mutex::scoped_lock ScopedLock;
+typedef boost::condition_variable Condition;
+
+/// \brief Get the number of hardware threads of the host or 0 if not known
+inline unsigned int nofHardwareThreads()
+{
+	return boost::thread::hardware_concurrency();
+}
+
 }} //namespace
 #endif
 
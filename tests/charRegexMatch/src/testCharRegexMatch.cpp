@@ -13,6 +13,7 @@
 #include "strus/patternLexerInstanceInterface.hpp"
 #include "strus/patternLexerContextInterface.hpp"
 #include "strus/analyzer/patternLexem.hpp"
+#include "strus/patternLexemBatch.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
@@ -27,6 +28,7 @@
 #include <cmath>
 #include <cstring>
 #include <iomanip>
+#include <algorithm>
 
 #undef STRUS_LOWLEVEL_DEBUG
 
@@ -62,6 +64,7 @@ struct TestDef
 	const SymbolDef symbols[64];
 	const char* src;
 	ResultDef result[128];
+	const char* option;
 };
 
 static void compile( strus::PatternLexerInstanceInterface* ptinst, const PatternDef* par, const SymbolDef* sar)
@@ -194,6 +197,99 @@ static const TestDef g_tests[32] =
 			{0,0,0,0}
 		}
 	},
+	{
+		{
+			{1,"abcdef ~H1",0,1,true},
+			{0,0,0,0,false}
+		},
+		{
+			{0,0,0}
+		},
+		//... only the substitution is found, not the insertion "abcXdef" and not the deletion "abcef":
+		"abcdef abXdef abcXdef abcef zzz",
+		{
+			{1,1,0,6},
+			{1,2,7,6},
+			{0,0,0,0}
+		}
+	},
+	{
+		{
+			{1,"\\bcat\\b",0,1,true},
+			{2,"cats",0,1,true},
+			{3,"[0-9]+",0,2,true},
+			{0,0,0,0,false}
+		},
+		{
+			{0,0,0}
+		},
+		"cat cats 42 concat",
+		{
+			{1,1,0,3},
+			{2,2,4,4},
+			{3,3,9,2},
+			{0,0,0,0}
+		},
+		"GAZETTEER"
+	},
+	{
+		{
+			{1,"\\bK\xC3\x84SE\\b",0,1,true}, //... "KÄSE"
+			{2,"[0-9]+\\s*EUR",0,1,true},
+			{0,0,0,0,false}
+		},
+		{
+			{0,0,0}
+		},
+		"K\xC3\xA4se kostet 12 eur, KASE 3 Eur",
+		{
+			{1,1,0,5},
+			{2,2,13,6},
+			{2,3,26,5},
+			{0,0,0,0}
+		},
+		"CASEFOLD"
+	},
+	{
+		{
+			{1,"\xD3\x81\xD4\xB1",0,2,true}, //... "ӁԱ"
+			{2,"[\xD4\xB1-\xD5\x96]+",0,1,true}, //... "[Ա-Ֆ]+"
+			{3,"KILO",0,1,true},
+			{4,"\xC8\xBA\xE1\xB8\x80",0,1,true}, //... "ȺḀ"
+			{0,0,0,0,false}
+		},
+		{
+			{0,0,0}
+		},
+		//... "ӂա Kilo ԲբԳ ⱥḁ ȺḀ" with the Kelvin sign and "Ⱥ" having a lower case with a UTF-8 encoding of a different size:
+		"\xD3\x82\xD5\xA1 \xE2\x84\xAAilo \xD4\xB2\xD5\xA2\xD4\xB3 \xE2\xB1\xA5\xE1\xB8\x81 \xC8\xBA\xE1\xB8\x80",
+		{
+			{1,1,0,4},
+			{3,2,5,6},
+			{2,3,12,6},
+			{4,4,19,6},
+			{4,5,26,5},
+			{0,0,0,0}
+		},
+		"CASEFOLD"
+	},
+	{
+		{
+			{1,"\\b[Z-a]x\\b",0,1,true},
+			{0,0,0,0,false}
+		},
+		{
+			{0,0,0}
+		},
+		"ZX _x zx bx",
+		{
+			{1,1,0,2},
+			{1,2,3,2},
+			{1,3,6,2},
+			{0,0,0,0}
+		},
+		"CASEFOLD"
+	},
 	{
 		{
 			{0,0,0,0,false}
@@ -208,6 +304,422 @@ static const TestDef g_tests[32] =
 	}
 };
 
+static const PatternDef g_chunkedScanPatterns[] =
+{
+	{1,"\\b[0-9]{1,4}\\b",0,2,true},
+	{2,"\\b[a-zA-Z]{1,12}\\b",0,1,true},
+	{3,"[a-z]{2,8} [0-9]{4}",0,3,false},
+	{4,"still",0,1,true},
+	{0,0,0,0,false}
+};
+
+static const SymbolDef g_chunkedScanSymbols[] =
+{
+	{0,0,0}
+};
+
+static bool isEqualResult( const std::vector<strus::analyzer::PatternLexem>& res1, const std::vector<strus::analyzer::PatternLexem>& res2)
+{
+	if (res1.size() != res2.size()) return false;
+	std::vector<strus::analyzer::PatternLexem>::const_iterator i1 = res1.begin(), e1 = res1.end(), i2 = res2.begin();
+	for (; i1 != e1; ++i1,++i2)
+	{
+		if (i1->id() != i2->id() || i1->ordpos() != i2->ordpos() || i1->origpos() != i2->origpos() || i1->origsize() != i2->origsize()) return false;
+	}
+	return true;
+}
+
+/// \brief Test that scanning a big document in parallel chunks gives the same result as a sequential scan
+static void testChunkedScan( const strus::PatternLexerInterface* pt)
+{
+	std::string src;
+	while (src.size() < (1<<19))
+	{
+		src.append( "The world was not created about 5000 years ago as some creationists still believe in the 21th century. ");
+	}
+	std::auto_ptr<strus::PatternLexerInstanceInterface> seqinst( pt->createInstance());
+	std::auto_ptr<strus::PatternLexerInstanceInterface> parinst( pt->createInstance());
+	if (!seqinst.get() || !parinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	parinst->defineOption( "THREADS", 4);
+	compile( seqinst.get(), g_chunkedScanPatterns, g_chunkedScanSymbols);
+	compile( parinst.get(), g_chunkedScanPatterns, g_chunkedScanSymbols);
+	std::vector<strus::analyzer::PatternLexem> seqresult = match( seqinst.get(), src);
+	std::vector<strus::analyzer::PatternLexem> parresult = match( parinst.get(), src);
+	if (g_errorBuffer->hasError())
+	{
+		throw std::runtime_error( "error matching");
+	}
+	if (seqresult.empty() || !isEqualResult( seqresult, parresult))
+	{
+		throw std::runtime_error( "test chunked scan failed");
+	}
+}
+
+struct MemoryChunkReader
+{
+	const std::string* src;
+	std::size_t pos;
+	std::size_t chunksize;
+};
+
+static bool readMemoryChunk( void* reader, char* buf, std::size_t bufsize, std::size_t& readsize)
+{
+	MemoryChunkReader* rd = (MemoryChunkReader*)reader;
+	readsize = rd->src->size() - rd->pos;
+	if (readsize > rd->chunksize) readsize = rd->chunksize;
+	if (readsize > bufsize) readsize = bufsize;
+	std::memcpy( buf, rd->src->c_str() + rd->pos, readsize);
+	rd->pos += readsize;
+	return true;
+}
+
+/// \brief Test that matching a big document fed in chunks gives the same result as matching it at once
+static void testStreamScan( const strus::PatternLexerInterface* pt)
+{
+	std::string src;
+	while (src.size() < (1<<18))
+	{
+		src.append( "The world was not created about 5000 years ago as some creationists still believe in the 21th century. ");
+	}
+	std::auto_ptr<strus::PatternLexerInstanceInterface> seqinst( pt->createInstance());
+	std::auto_ptr<strus::PatternLexerInstanceInterface> streaminst( pt->createInstance());
+	if (!seqinst.get() || !streaminst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	streaminst->defineOption( "STREAM", 0);
+	compile( seqinst.get(), g_chunkedScanPatterns, g_chunkedScanSymbols);
+	compile( streaminst.get(), g_chunkedScanPatterns, g_chunkedScanSymbols);
+	std::vector<strus::analyzer::PatternLexem> seqresult = match( seqinst.get(), src);
+
+	std::auto_ptr<strus::PatternLexerContextInterface> mt( streaminst->createContext());
+	if (!mt.get()) throw std::runtime_error("failed to create regular expression term matcher context");
+	std::vector<strus::analyzer::PatternLexem> feedresult;
+	if (!strus::openPatternLexerStream( mt.get(), g_errorBuffer))
+	{
+		throw std::runtime_error( "error opening stream");
+	}
+	std::size_t pos = 0;
+	while (pos < src.size())
+	{
+		std::size_t chunksize = std::min( (std::size_t)997, src.size() - pos);
+		if (!strus::feedPatternLexerStream( feedresult, mt.get(), src.c_str() + pos, chunksize, g_errorBuffer))
+		{
+			throw std::runtime_error( "error feeding stream");
+		}
+		pos += chunksize;
+	}
+	if (!strus::closePatternLexerStream( feedresult, mt.get(), g_errorBuffer))
+	{
+		throw std::runtime_error( "error closing stream");
+	}
+	if (seqresult.empty() || !isEqualResult( seqresult, feedresult))
+	{
+		throw std::runtime_error( "test stream scan with chunks fed failed");
+	}
+
+	std::vector<strus::analyzer::PatternLexem> pipelineresult;
+	MemoryChunkReader reader;
+	reader.src = &src;
+	reader.pos = 0;
+	reader.chunksize = 3001;
+	if (!strus::matchPatternLexerStream( pipelineresult, mt.get(), &readMemoryChunk, &reader, g_errorBuffer))
+	{
+		throw std::runtime_error( "error matching stream");
+	}
+	if (!isEqualResult( seqresult, pipelineresult))
+	{
+		throw std::runtime_error( "test stream scan with chunk reader failed");
+	}
+}
+
+/// \brief Test that the columnar lexem batch of a document survives serialization and equals the result of match
+static void testLexemBatch( const strus::PatternLexerInterface* pt)
+{
+	std::string src( g_tests[0].src);
+	std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+	if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	compile( ptinst.get(), g_tests[0].patterns, g_tests[0].symbols);
+	std::vector<strus::analyzer::PatternLexem> result = match( ptinst.get(), src);
+
+	std::auto_ptr<strus::PatternLexerContextInterface> mt( ptinst->createContext());
+	if (!mt.get()) throw std::runtime_error("failed to create regular expression term matcher context");
+	strus::PatternLexemBatch batch;
+	if (!strus::matchPatternLexemBatch( batch, mt.get(), src.c_str(), src.size(), g_errorBuffer))
+	{
+		throw std::runtime_error( "error matching lexem batch");
+	}
+	int di = 0;
+	for (; di < 2; ++di)
+	{
+		std::string image;
+		strus::PatternLexemBatch batchcopy;
+		if (!strus::serializePatternLexemBatch( image, batch, di==1/*deltaEncoding*/, g_errorBuffer)
+		||  !strus::deserializePatternLexemBatch( batchcopy, image.c_str(), image.size(), g_errorBuffer))
+		{
+			throw std::runtime_error( "error serializing lexem batch");
+		}
+		std::vector<strus::analyzer::PatternLexem> batchresult;
+		std::size_t bi = 0, be = batchcopy.size();
+		for (; bi != be; ++bi)
+		{
+			batchresult.push_back( batchcopy[ bi]);
+		}
+		if (result.empty() || !isEqualResult( result, batchresult))
+		{
+			throw std::runtime_error( "test lexem batch failed");
+		}
+	}
+}
+
+static void testLexemMask( const strus::PatternLexerInterface* pt)
+{
+	std::string src( g_tests[0].src);
+	std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+	if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	compile( ptinst.get(), g_tests[0].patterns, g_tests[0].symbols);
+	std::vector<strus::analyzer::PatternLexem> result = match( ptinst.get(), src);
+	if (result.empty()) throw std::runtime_error( "test lexem mask failed (no lexems matched)");
+
+	std::auto_ptr<strus::PatternLexerContextInterface> mt( ptinst->createContext());
+	if (!mt.get()) throw std::runtime_error("failed to create regular expression term matcher context");
+	std::vector<unsigned int> enabledIds;
+	enabledIds.push_back( 1);
+	if (!strus::setPatternLexerContextLexemMask( mt.get(), enabledIds, g_errorBuffer))
+	{
+		throw std::runtime_error( "error setting lexem mask");
+	}
+	std::vector<strus::analyzer::PatternLexem> maskedresult = mt->match( src.c_str(), src.size());
+	std::vector<strus::analyzer::PatternLexem>::const_iterator ri = maskedresult.begin(), re = maskedresult.end();
+	for (; ri != re; ++ri)
+	{
+		if (ri->id() != 1) throw std::runtime_error( "test lexem mask failed (disabled lexem reported)");
+	}
+	if (maskedresult.empty()) throw std::runtime_error( "test lexem mask failed (enabled lexem not reported)");
+
+	enabledIds.clear();
+	if (!strus::setPatternLexerContextLexemMask( mt.get(), enabledIds, g_errorBuffer))
+	{
+		throw std::runtime_error( "error setting lexem mask");
+	}
+	if (!mt->match( src.c_str(), src.size()).empty())
+	{
+		throw std::runtime_error( "test lexem mask failed (lexems reported with empty mask)");
+	}
+
+	if (!strus::clearPatternLexerContextLexemMask( mt.get(), g_errorBuffer))
+	{
+		throw std::runtime_error( "error clearing lexem mask");
+	}
+	if (!isEqualResult( result, mt->match( src.c_str(), src.size())))
+	{
+		throw std::runtime_error( "test lexem mask failed (not all lexems reported after reset of mask)");
+	}
+}
+
+static void testReferencedLexems( const strus::PatternLexerInterface* pt)
+{
+	std::string src( g_tests[0].src);
+	std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+	if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	compile( ptinst.get(), g_tests[0].patterns, g_tests[0].symbols);
+	std::vector<strus::analyzer::PatternLexem> result = match( ptinst.get(), src);
+
+	// Lexem 4 is not referenced, does not define positions and has the lowest level, so it is left out:
+	std::vector<strus::analyzer::PatternLexem> expected;
+	std::vector<strus::analyzer::PatternLexem>::const_iterator ri = result.begin(), re = result.end();
+	for (; ri != re; ++ri)
+	{
+		if (ri->id() != 4) expected.push_back( *ri);
+	}
+	std::auto_ptr<strus::PatternLexerInstanceInterface> refinst( pt->createInstance());
+	if (!refinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	std::vector<unsigned int> referenced;
+	referenced.push_back( 2);
+	if (!strus::definePatternLexerReferencedLexems( refinst.get(), referenced, g_errorBuffer))
+	{
+		throw std::runtime_error( "error defining referenced lexems");
+	}
+	compile( refinst.get(), g_tests[0].patterns, g_tests[0].symbols);
+	if (expected.size() == result.size() || !isEqualResult( expected, match( refinst.get(), src)))
+	{
+		throw std::runtime_error( "test referenced lexems failed");
+	}
+}
+
+/// \brief Test that an expression with a Hamming distance suffix without distance is rejected
+static void testHammingDistanceMalformed( const strus::PatternLexerInterface* pt)
+{
+	std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+	if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	ptinst->defineLexem( 1, "abcdef ~H", 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindContent);
+	if (!g_errorBuffer->hasError())
+	{
+		throw std::runtime_error( "test malformed Hamming distance failed (expression not rejected)");
+	}
+	(void)g_errorBuffer->fetchError();
+}
+
+/// \brief Test that a lexem bound to its successor between two lexems with unique position is not left out if not referenced, because it makes the second lexem with unique position being reported
+static void testReferencedLexemsMixedPosBind( const strus::PatternLexerInterface* pt)
+{
+	std::string src( "u s u");
+	std::vector<strus::analyzer::PatternLexem> result;
+	std::vector<strus::analyzer::PatternLexem> refresult;
+	int ii = 0;
+	for (; ii < 2; ++ii)
+	{
+		std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+		if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+		if (ii == 1)
+		{
+			std::vector<unsigned int> referenced;
+			referenced.push_back( 1);
+			if (!strus::definePatternLexerReferencedLexems( ptinst.get(), referenced, g_errorBuffer))
+			{
+				throw std::runtime_error( "error defining referenced lexems");
+			}
+		}
+		ptinst->defineLexem( 1, "\\bu\\b", 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindUnique);
+		ptinst->defineLexem( 2, "\\bs\\b", 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindSuccessor);
+		if (!ptinst->compile())
+		{
+			throw std::runtime_error("error building term match automaton");
+		}
+		(ii == 0 ? result : refresult) = match( ptinst.get(), src);
+	}
+	// The lexem 2 may be left out, but the lexem 1 at the end has to be reported in both cases:
+	std::vector<strus::analyzer::PatternLexem> expected;
+	std::vector<strus::analyzer::PatternLexem> refexpected;
+	std::vector<strus::analyzer::PatternLexem>::const_iterator ri = result.begin(), re = result.end();
+	for (; ri != re; ++ri)
+	{
+		if (ri->id() == 1) expected.push_back( *ri);
+	}
+	for (ri = refresult.begin(), re = refresult.end(); ri != re; ++ri)
+	{
+		if (ri->id() == 1) refexpected.push_back( *ri);
+	}
+	if (expected.size() != 2 || !isEqualResult( expected, refexpected))
+	{
+		throw std::runtime_error( "test referenced lexems with mixed position binding failed");
+	}
+}
+
+/// \brief Test that expressions with character classes depending on case are rejected with case folding, because they can not match a source mapped to lower case
+static void testCaseFoldCaseDependentClass( const strus::PatternLexerInterface* pt)
+{
+	static const char* exprar[] = {"\\p{Lu}+", "[[:upper:]]+", 0};
+	std::size_t ei = 0;
+	for (; exprar[ ei]; ++ei)
+	{
+		std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+		if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+		ptinst->defineOption( "CASEFOLD", 0);
+		ptinst->defineLexem( 1, exprar[ ei], 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindContent);
+		if (ptinst->compile())
+		{
+			throw std::runtime_error( "test case fold with case dependent class failed (expression not rejected)");
+		}
+		if (!g_errorBuffer->hasError())
+		{
+			throw std::runtime_error( "test case fold with case dependent class failed (no error reported)");
+		}
+		(void)g_errorBuffer->fetchError();
+	}
+}
+
+/// \brief Test lexems defined as logical combination of other lexems, evaluated on the operand matches within a bounded span
+static void testLexemCombination( const strus::PatternLexerInterface* pt)
+{
+	std::string src( "foo bar zzzzzzzzzzzzzzzzzzzz foo baz bar zzzzzzzzzzzzzzzzzzzz bar foo");
+	std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+	if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	ptinst->defineLexem( 1, "\\bfoo\\b", 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindContent);
+	ptinst->defineLexem( 2, "\\bbar\\b", 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindContent);
+	ptinst->defineLexem( 3, "\\bbaz\\b", 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindContent);
+	if (!strus::definePatternLexemCombination( ptinst.get(), 10, "1 & 2 & !3", 12/*span*/, 1/*level*/, strus::analyzer::BindContent, g_errorBuffer))
+	{
+		throw std::runtime_error( "error defining lexem combination");
+	}
+	if (!ptinst->compile())
+	{
+		throw std::runtime_error("error building term match automaton");
+	}
+	// The second "foo" is too far from the first "bar", the second "bar" has a "baz" within the span:
+	std::vector<strus::analyzer::PatternLexem> result = match( ptinst.get(), src);
+	std::vector<strus::analyzer::PatternLexem> combinations;
+	std::vector<strus::analyzer::PatternLexem>::const_iterator ri = result.begin(), re = result.end();
+	for (; ri != re; ++ri)
+	{
+		if (ri->id() == 10) combinations.push_back( *ri);
+	}
+	if (combinations.size() != 2
+	||  combinations[0].origpos() != 0 || combinations[0].origsize() != 7
+	||  combinations[1].origpos() != 62 || combinations[1].origsize() != 7)
+	{
+		throw std::runtime_error( "test lexem combination failed");
+	}
+
+	// A combination that is true without any operand match is rejected:
+	std::auto_ptr<strus::PatternLexerInstanceInterface> neginst( pt->createInstance());
+	if (!neginst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	neginst->defineLexem( 3, "\\bbaz\\b", 0/*resultIndex*/, 1/*level*/, strus::analyzer::BindContent);
+	(void)strus::definePatternLexemCombination( neginst.get(), 10, "!3", 12/*span*/, 1/*level*/, strus::analyzer::BindContent, g_errorBuffer);
+	if (neginst->compile())
+	{
+		throw std::runtime_error( "test lexem combination failed (combination true without operand match not rejected)");
+	}
+	(void)g_errorBuffer->fetchError();
+}
+
+/// \brief Test that a source with ASCII characters only gives the same matches as the same source with a non ASCII character appended
+/// \note Sources with ASCII characters only are scanned with an automaton built without Unicode flags, if the expressions depend on these flags
+static void testAsciiSourceEquivalence( const strus::PatternLexerInterface* pt, const char* option, const PatternDef* patterns)
+{
+	std::string src( "The Quick brown fox jumps over 12 lazy dogs, the 3rd time since 2019. Lorem ipsum dolor sit amet cafe ");
+	std::string src_nonascii( src + "\xC3\xA4");
+
+	std::auto_ptr<strus::PatternLexerInstanceInterface> ptinst( pt->createInstance());
+	if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
+	if (option) ptinst->defineOption( option, 0);
+	compile( ptinst.get(), patterns, g_chunkedScanSymbols);
+
+	std::vector<strus::analyzer::PatternLexem> result = match( ptinst.get(), src);
+	std::vector<strus::analyzer::PatternLexem> result_nonascii;
+	std::vector<strus::analyzer::PatternLexem> result_nonascii_all = match( ptinst.get(), src_nonascii);
+	std::vector<strus::analyzer::PatternLexem>::const_iterator ri = result_nonascii_all.begin(), re = result_nonascii_all.end();
+	for (; ri != re; ++ri)
+	{
+		//... matches covering the appended character have no counterpart in the ASCII source
+		if (ri->origpos() + ri->origsize() <= src.size()) result_nonascii.push_back( *ri);
+	}
+	if (g_errorBuffer->hasError())
+	{
+		throw std::runtime_error( "error matching");
+	}
+	if (result.empty() || !isEqualResult( result, result_nonascii))
+	{
+		throw std::runtime_error( "test ASCII source equivalence failed");
+	}
+}
+
+static const PatternDef g_unicodeSensitivePatterns[] =
+{
+	{1,"\\b\\w+\\b",0,1,true},
+	{2,"[A-Z][^ ,.]+",0,2,true},
+	{3,"\\d+\\D",0,2,true},
+	{4,"o.e",0,2,true},
+	{5,"[[:alpha:]]{4}\\s",0,2,true},
+	{6,"(?i)the\\W",0,3,true},
+	{0,0,0,0,false}
+};
+
+static const PatternDef g_unicodeInsensitivePatterns[] =
+{
+	{1,"[a-zA-Z]+",0,1,true},
+	{2,"[0-9]+(rd|th)?",0,2,true},
+	{3,"fox|dogs?",0,3,true},
+	{4,"[.,]",0,1,false},
+	{0,0,0,0,false}
+};
 
 int main( int argc, const char** argv)
 {
@@ -234,6 +746,10 @@ int main( int argc, const char** argv)
 			if (!ptinst.get()) throw std::runtime_error("failed to create regular expression term matcher instance");
 
 			ptinst->defineOption( "DOTALL", 0);
+			if (g_tests[ti].option)
+			{
+				ptinst->defineOption( g_tests[ti].option, 0);
+			}
 			compile( ptinst.get(), g_tests[ti].patterns, g_tests[ti].symbols);
 			if (g_errorBuffer->hasError())
 			{
@@ -260,6 +776,29 @@ int main( int argc, const char** argv)
 				throw std::runtime_error( "test failed");
 			}
 		}
+		std::cerr << "executing test malformed Hamming distance" << std::endl;
+		testHammingDistanceMalformed( pt.get());
+		std::cerr << "executing test chunked scan" << std::endl;
+		testChunkedScan( pt.get());
+		std::cerr << "executing test stream scan" << std::endl;
+		testStreamScan( pt.get());
+		std::cerr << "executing test lexem batch" << std::endl;
+		testLexemBatch( pt.get());
+		std::cerr << "executing test lexem mask" << std::endl;
+		testLexemMask( pt.get());
+		std::cerr << "executing test referenced lexems" << std::endl;
+		testReferencedLexems( pt.get());
+		std::cerr << "executing test referenced lexems with mixed position binding" << std::endl;
+		testReferencedLexemsMixedPosBind( pt.get());
+		std::cerr << "executing test case fold with case dependent class" << std::endl;
+		testCaseFoldCaseDependentClass( pt.get());
+		std::cerr << "executing test lexem combination" << std::endl;
+		testLexemCombination( pt.get());
+		std::cerr << "executing test ASCII source equivalence" << std::endl;
+		testAsciiSourceEquivalence( pt.get(), 0, g_unicodeSensitivePatterns);
+		testAsciiSourceEquivalence( pt.get(), "UCP", g_unicodeSensitivePatterns);
+		testAsciiSourceEquivalence( pt.get(), "CASELESS", g_unicodeSensitivePatterns);
+		testAsciiSourceEquivalence( pt.get(), 0, g_unicodeInsensitivePatterns);
 		std::cerr << "OK" << std::endl;
 		delete g_errorBuffer;
 		return 0;
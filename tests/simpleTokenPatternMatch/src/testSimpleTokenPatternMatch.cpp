@@ -13,6 +13,7 @@
 #include "strus/patternMatcherInstanceInterface.hpp"
 #include "strus/patternMatcherContextInterface.hpp"
 #include "strus/analyzer/patternLexem.hpp"
+#include "strus/patternLexemBatch.hpp"
 #include "testUtils.hpp"
 #include <stdexcept>
 #include <iostream>
@@ -29,6 +30,7 @@
 #include <cmath>
 #include <cstring>
 #include <iomanip>
+#include <algorithm>
 
 #undef STRUS_LOWLEVEL_DEBUG
 
@@ -153,7 +155,7 @@ static void createPatterns( strus::PatternMatcherInstanceInterface* ptinst, cons
 }
 
 static std::vector<strus::analyzer::PatternMatcherResult>
-	processDocument( strus::PatternMatcherInstanceInterface* ptinst, const Document& doc)
+	processDocument( const strus::PatternMatcherInstanceInterface* ptinst, const Document& doc)
 {
 	std::vector<strus::analyzer::PatternMatcherResult> results;
 	std::auto_ptr<strus::PatternMatcherContextInterface> mt( ptinst->createContext());
@@ -217,6 +219,459 @@ static const Pattern testPatterns[32] =
 	{0,{Operation::None}}
 };
 
+typedef std::pair<std::string,unsigned int> Match;
+
+static std::set<Match> getMatchSet( const std::vector<strus::analyzer::PatternMatcherResult>& results)
+{
+	std::set<Match> rt;
+	std::vector<strus::analyzer::PatternMatcherResult>::const_iterator ri = results.begin(), re = results.end();
+	for (; ri != re; ++ri)
+	{
+		rt.insert( Match( ri->name(), ri->start_ordpos()));
+	}
+	return rt;
+}
+
+static std::vector<strus::analyzer::PatternLexem> getLexemArray( const Document& doc)
+{
+	std::vector<strus::analyzer::PatternLexem> rt;
+	std::vector<DocumentItem>::const_iterator di = doc.itemar.begin(), de = doc.itemar.end();
+	unsigned int didx = 0;
+	for (; di != de; ++di,++didx)
+	{
+		rt.push_back( strus::analyzer::PatternLexem( di->termid, di->pos, 0/*origseg*/, didx, 1));
+	}
+	return rt;
+}
+
+static strus::PatternLexemBatch getLexemBatch( const Document& doc)
+{
+	strus::PatternLexemBatch rt;
+	std::vector<DocumentItem>::const_iterator di = doc.itemar.begin(), de = doc.itemar.end();
+	unsigned int didx = 0;
+	for (; di != de; ++di,++didx)
+	{
+		rt.push_back( di->termid, di->pos, 0/*origseg*/, didx, 1);
+	}
+	return rt;
+}
+
+static std::string getImage( const strus::PatternMatcherInstanceInterface* ptinst)
+{
+	std::string rt;
+	if (!strus::getPatternMatcherImage( rt, ptinst, g_errorBuffer))
+	{
+		throw std::runtime_error( "error getting the binary image of the pattern matcher");
+	}
+	return rt;
+}
+
+// Evaluate results with the token 3 missing in the vocabulary, the patterns referencing it must be eliminated:
+static void testTermVocabulary( const strus::PatternMatcherInterface* pt, const Document& doc, const std::set<Match>& allMatches)
+{
+	std::auto_ptr<strus::PatternMatcherInstanceInterface> vocptinst( pt->createInstance());
+	if (!vocptinst.get()) throw std::runtime_error("failed to create pattern matcher instance");
+	createPatterns( vocptinst.get(), testPatterns);
+	std::vector<unsigned int> vocabulary;
+	vocabulary.push_back( TOKEN(1));
+	vocabulary.push_back( TOKEN(2));
+	vocabulary.push_back( DELIM);
+	if (!strus::definePatternMatcherTermVocabulary( vocptinst.get(), vocabulary, g_errorBuffer))
+	{
+		throw std::runtime_error( "error defining the term vocabulary");
+	}
+	vocptinst->compile();
+	std::set<Match> vocmatches = getMatchSet( processDocument( vocptinst.get(), doc));
+	std::set<Match> vocexpected;
+	std::set<Match>::const_iterator li = allMatches.begin(), le = allMatches.end();
+	for (; li != le; ++li)
+	{
+		if (li->first.find( "_3") == std::string::npos) vocexpected.insert( *li);
+	}
+	if (vocmatches != vocexpected)
+	{
+		throw std::runtime_error( "matches with term vocabulary differ from the matches expected");
+	}
+}
+
+// Evaluate results with the automaton loaded from its binary image, they must be the same as with the original automaton:
+static void testImage( const strus::PatternMatcherInterface* pt, const strus::PatternMatcherInstanceInterface* ptinst, const Document& doc, const std::set<Match>& allMatches)
+{
+	std::string image = getImage( ptinst);
+	std::auto_ptr<strus::PatternMatcherInstanceInterface> imgptinst( pt->createInstance());
+	if (!imgptinst.get()) throw std::runtime_error("failed to create pattern matcher instance");
+	if (!strus::loadPatternMatcherImage( imgptinst.get(), image.c_str(), image.size(), g_errorBuffer))
+	{
+		throw std::runtime_error( "error loading the pattern matcher from its binary image");
+	}
+	if (getMatchSet( processDocument( imgptinst.get(), doc)) != allMatches)
+	{
+		throw std::runtime_error( "matches with the automaton loaded from its image differ from the matches of the original");
+	}
+}
+
+// Evaluate results with the automaton loaded from its binary image stored in a file, they must be the same as with the original automaton:
+static void testImageFile( const strus::PatternMatcherInterface* pt, const strus::PatternMatcherInstanceInterface* ptinst, const Document& doc, const std::set<Match>& allMatches)
+{
+	std::string image = getImage( ptinst);
+	const char* imagefile = "testSimpleTokenPatternMatch.img";
+	{
+		FILE* fh = ::fopen( imagefile, "wb");
+		if (!fh) throw std::runtime_error( "error creating the binary image file of the pattern matcher");
+		bool written = (::fwrite( image.c_str(), 1, image.size(), fh) == image.size());
+		if (::fclose( fh) != 0 || !written) throw std::runtime_error( "error writing the binary image file of the pattern matcher");
+	}
+	std::auto_ptr<strus::PatternMatcherInstanceInterface> fileptinst( pt->createInstance());
+	if (!fileptinst.get()) throw std::runtime_error("failed to create pattern matcher instance");
+	if (!strus::loadPatternMatcherImageFile( fileptinst.get(), imagefile, g_errorBuffer))
+	{
+		::remove( imagefile);
+		throw std::runtime_error( "error loading the pattern matcher from its binary image file");
+	}
+	std::set<Match> filematches = getMatchSet( processDocument( fileptinst.get(), doc));
+	::remove( imagefile);
+	if (filematches != allMatches)
+	{
+		throw std::runtime_error( "matches with the automaton loaded from its image file differ from the matches of the original");
+	}
+}
+
+// A truncated image and an image with a stop word index out of range must be rejected:
+static void testCorruptImage( const strus::PatternMatcherInterface* pt, const strus::PatternMatcherInstanceInterface* ptinst)
+{
+	std::string image = getImage( ptinst);
+	{
+		std::auto_ptr<strus::PatternMatcherInstanceInterface> corruptptinst( pt->createInstance());
+		if (!corruptptinst.get()) throw std::runtime_error("failed to create pattern matcher instance");
+		if (strus::loadPatternMatcherImage( corruptptinst.get(), image.c_str(), image.size() - 4, g_errorBuffer))
+		{
+			throw std::runtime_error( "truncated binary image of the pattern matcher not rejected");
+		}
+		(void)g_errorBuffer->fetchError();
+	}
+	{
+		// ... the key event table is the last array of the image, an array of entries {event, program list, stop word index} preceded by the element size and the number of elements:
+		typedef uint32_t KeyEventEntry[3];
+		std::string corruptimage( image);
+		std::size_t tablesize = 1;
+		for (; tablesize * sizeof(KeyEventEntry) + 8 <= corruptimage.size(); tablesize *= 2)
+		{
+			uint32_t header[ 2];
+			std::memcpy( header, corruptimage.c_str() + corruptimage.size() - tablesize * sizeof(KeyEventEntry) - 8, sizeof(header));
+			if (header[0] == sizeof(KeyEventEntry) && header[1] == tablesize) break;
+		}
+		if (tablesize * sizeof(KeyEventEntry) + 8 > corruptimage.size())
+		{
+			throw std::runtime_error( "key event table not found in the binary image of the pattern matcher");
+		}
+		std::size_t tablepos = corruptimage.size() - tablesize * sizeof(KeyEventEntry);
+		std::size_t ei = 0;
+		for (; ei < tablesize; ++ei)
+		{
+			KeyEventEntry entry;
+			std::memcpy( entry, corruptimage.c_str() + tablepos + ei * sizeof(KeyEventEntry), sizeof(entry));
+			if (entry[0] != 0)
+			{
+				entry[2] = tablesize + 1;
+				std::memcpy( &corruptimage[ tablepos + ei * sizeof(KeyEventEntry)], entry, sizeof(entry));
+				break;
+			}
+		}
+		std::auto_ptr<strus::PatternMatcherInstanceInterface> corruptptinst( pt->createInstance());
+		if (!corruptptinst.get()) throw std::runtime_error("failed to create pattern matcher instance");
+		if (ei == tablesize || strus::loadPatternMatcherImage( corruptptinst.get(), corruptimage.c_str(), corruptimage.size(), g_errorBuffer))
+		{
+			throw std::runtime_error( "binary image of the pattern matcher with a stop word index out of range not rejected");
+		}
+		(void)g_errorBuffer->fetchError();
+	}
+}
+
+// Image layout: magic (4 bytes), 4 words (version, byte order mark, exclusive flag, maximum result size) and the arrays
+// (variable name positions, variable names, pattern name positions, pattern names, programs, triggers, program triggers, key events),
+// each as a header {element size, number of elements} followed by the elements, headers and elements aligned to 8 bytes:
+enum ImageArray {ImageProgramArray=4, ImageTriggerArray=5, ImageProgramTriggerArray=6, ImageKeyEventArray=7};
+
+static std::size_t getImageArrayPos( const std::string& image, ImageArray arrayidx, uint32_t& elemsize, uint32_t& size)
+{
+	std::size_t pos = 4 + 4 * sizeof(uint32_t);
+	int ai = 0;
+	for (;; ++ai)
+	{
+		pos = (pos + 7) & ~(std::size_t)7;
+		uint32_t header[ 2];
+		if (pos + sizeof(header) > image.size())
+		{
+			throw std::runtime_error( "array not found in the binary image of the pattern matcher");
+		}
+		std::memcpy( header, image.c_str() + pos, sizeof(header));
+		pos += sizeof(header);
+		if (ai == arrayidx)
+		{
+			elemsize = header[0];
+			size = header[1];
+			if (!size || elemsize % sizeof(uint32_t) != 0)
+			{
+				throw std::runtime_error( "unexpected layout of an array in the binary image of the pattern matcher");
+			}
+			return pos;
+		}
+		pos += header[0] * header[1];
+	}
+}
+
+static uint32_t getImageWord( const std::string& image, std::size_t pos)
+{
+	uint32_t rt;
+	std::memcpy( &rt, image.c_str() + pos, sizeof(rt));
+	return rt;
+}
+
+static void setImageWord( std::string& image, std::size_t pos, uint32_t value)
+{
+	std::memcpy( &image[ pos], &value, sizeof(value));
+}
+
+static void checkImageRejected( const strus::PatternMatcherInterface* pt, const std::string& image, const char* what)
+{
+	std::auto_ptr<strus::PatternMatcherInstanceInterface> corruptptinst( pt->createInstance());
+	if (!corruptptinst.get()) throw std::runtime_error("failed to create pattern matcher instance");
+	if (strus::loadPatternMatcherImage( corruptptinst.get(), image.c_str(), image.size(), g_errorBuffer))
+	{
+		throw std::runtime_error( std::string("binary image of the pattern matcher with ") + what + " not rejected");
+	}
+	(void)g_errorBuffer->fetchError();
+}
+
+// An image with a program, trigger or list index out of range or with a circular list must be rejected:
+static void testCorruptImageIndex( const strus::PatternMatcherInterface* pt, const strus::PatternMatcherInstanceInterface* ptinst)
+{
+	std::string image = getImage( ptinst);
+	uint32_t elemsize;
+	uint32_t size;
+	const uint32_t outOfRange = 0xFFFFFFF0U;
+	{
+		// ... program {initsigval, initcount, event, resultHandle, triggerListIdx, positionRange}
+		std::string corruptimage( image);
+		std::size_t pos = getImageArrayPos( corruptimage, ImageProgramArray, elemsize, size);
+		setImageWord( corruptimage, pos + 4 * sizeof(uint32_t), outOfRange);
+		checkImageRejected( pt, corruptimage, "a trigger list index out of range");
+	}
+	{
+		// ... program trigger {programidx, past_eventid, next}
+		std::string corruptimage( image);
+		std::size_t pos = getImageArrayPos( corruptimage, ImageProgramTriggerArray, elemsize, size);
+		setImageWord( corruptimage, pos, outOfRange);
+		checkImageRejected( pt, corruptimage, "a program index out of range");
+	}
+	{
+		// ... trigger {event, isKeyEvent and sigtype, sigval, variable, next}
+		std::string corruptimage( image);
+		std::size_t pos = getImageArrayPos( corruptimage, ImageTriggerArray, elemsize, size);
+		setImageWord( corruptimage, pos + elemsize - sizeof(uint32_t), outOfRange);
+		checkImageRejected( pt, corruptimage, "a trigger list link out of range");
+	}
+	{
+		// ... all links of the trigger list set to the same element, that is then linked to itself
+		std::string corruptimage( image);
+		std::size_t pos = getImageArrayPos( corruptimage, ImageTriggerArray, elemsize, size);
+		uint32_t link = 0;
+		uint32_t ti = 0;
+		for (; ti < size && !link; ++ti)
+		{
+			link = getImageWord( corruptimage, pos + (ti+1) * elemsize - sizeof(uint32_t));
+		}
+		if (!link) throw std::runtime_error( "no trigger list with more than one element in the binary image of the pattern matcher");
+		for (ti = 0; ti < size; ++ti)
+		{
+			setImageWord( corruptimage, pos + (ti+1) * elemsize - sizeof(uint32_t), link);
+		}
+		checkImageRejected( pt, corruptimage, "a circular trigger list");
+	}
+	{
+		// ... key event {event, programlist, stopword}
+		std::string corruptimage( image);
+		std::size_t pos = getImageArrayPos( corruptimage, ImageKeyEventArray, elemsize, size);
+		uint32_t ki = 0;
+		for (; ki < size && !getImageWord( corruptimage, pos + ki * elemsize); ++ki){}
+		if (ki == size) throw std::runtime_error( "no key event in the binary image of the pattern matcher");
+		setImageWord( corruptimage, pos + ki * elemsize + sizeof(uint32_t), outOfRange);
+		checkImageRejected( pt, corruptimage, "a program list index out of range");
+	}
+}
+
+// Evaluate results with the lexems fed as one array, they must be the same as with the lexems fed one by one.
+// An array of lexems not in ascending order of their position must be rejected before any lexem is fed:
+static void testLexemArray( const strus::PatternMatcherInstanceInterface* ptinst, const Document& doc, const std::set<Match>& allMatches)
+{
+	std::vector<strus::analyzer::PatternLexem> lexemar = getLexemArray( doc);
+	{
+		std::auto_ptr<strus::PatternMatcherContextInterface> mt( ptinst->createContext());
+		if (!mt.get()) throw std::runtime_error("failed to create pattern matcher context");
+		if (!strus::putInputPatternLexems( mt.get(), &lexemar[0], lexemar.size(), g_errorBuffer))
+		{
+			throw std::runtime_error( "error feeding the lexems as array");
+		}
+		std::vector<strus::analyzer::PatternMatcherResult> arrayresults = mt->fetchResults();
+		if (g_errorBuffer->hasError()) throw std::runtime_error("error matching rules");
+		if (getMatchSet( arrayresults) != allMatches)
+		{
+			throw std::runtime_error( "matches with the lexems fed as array differ from the matches with the lexems fed one by one");
+		}
+	}
+	{
+		std::size_t li = lexemar.size();
+		for (; li > 1 && lexemar[ li-2].ordpos() == lexemar[ li-1].ordpos(); --li){}
+		if (li <= 1) throw std::runtime_error( "no lexems with different positions in the test document");
+		std::swap( lexemar[ li-2], lexemar[ li-1]);
+
+		std::auto_ptr<strus::PatternMatcherContextInterface> mt( ptinst->createContext());
+		if (!mt.get()) throw std::runtime_error("failed to create pattern matcher context");
+		if (strus::putInputPatternLexems( mt.get(), &lexemar[0], lexemar.size(), g_errorBuffer))
+		{
+			throw std::runtime_error( "array of lexems not in ascending order of their position not rejected");
+		}
+		(void)g_errorBuffer->fetchError();
+		std::vector<strus::analyzer::PatternMatcherResult> rejectresults = mt->fetchResults();
+		if (g_errorBuffer->hasError()) throw std::runtime_error("error matching rules");
+		if (!rejectresults.empty())
+		{
+			throw std::runtime_error( "lexems of a rejected array have been fed to the pattern matcher");
+		}
+	}
+}
+
+// Evaluate results of documents of different sizes matched in parallel, they must be the same as matched one by one:
+static void testDocumentBatch( const strus::PatternMatcherInstanceInterface* ptinst, unsigned int documentSize)
+{
+	std::vector<Document> batchdocs;
+	std::vector<strus::PatternLexemBatch> batchinput;
+	unsigned int bi = 0;
+	for (; bi < 16; ++bi)
+	{
+		batchdocs.push_back( createDocument( bi+2, documentSize * (1 + bi % 5)));
+		batchinput.push_back( getLexemBatch( batchdocs.back()));
+	}
+	std::vector<std::vector<strus::analyzer::PatternMatcherResult> > batchresults;
+	if (!strus::matchPatternMatcherDocuments( batchresults, ptinst, batchinput, 4, g_errorBuffer))
+	{
+		throw std::runtime_error( "error matching a batch of documents");
+	}
+	if (batchresults.size() != batchdocs.size())
+	{
+		throw std::runtime_error( "number of results of the document batch does not match the number of documents");
+	}
+	for (bi = 0; bi < batchdocs.size(); ++bi)
+	{
+		if (getMatchSet( processDocument( ptinst, batchdocs[ bi])) != getMatchSet( batchresults[ bi]))
+		{
+			throw std::runtime_error( "matches of a document matched in a batch differ from the matches of the document matched alone");
+		}
+	}
+}
+
+static bool isEqualResultItem( const strus::analyzer::PatternMatcherResultItem& item1, const strus::analyzer::PatternMatcherResultItem& item2)
+{
+	return 0==std::strcmp( item1.name(), item2.name())
+		&& item1.start_ordpos() == item2.start_ordpos()
+		&& item1.end_ordpos() == item2.end_ordpos()
+		&& item1.start_origpos() == item2.start_origpos()
+		&& item1.end_origpos() == item2.end_origpos();
+}
+
+static bool isEqualResult( const strus::analyzer::PatternMatcherResult& res1, const strus::analyzer::PatternMatcherResult& res2)
+{
+	if (!isEqualResultItem( res1, res2) || res1.items().size() != res2.items().size()) return false;
+	std::vector<strus::analyzer::PatternMatcherResultItem>::const_iterator
+		i1 = res1.items().begin(), e1 = res1.items().end(),
+		i2 = res2.items().begin();
+	for (; i1 != e1; ++i1,++i2)
+	{
+		if (!isEqualResultItem( *i1, *i2)) return false;
+	}
+	return true;
+}
+
+// Match a document split into windows matched in parallel, the results (items and order) must be the same as matched sequentially:
+static void checkDocumentParallel( const strus::PatternMatcherInstanceInterface* ptinst, const Document& doc)
+{
+	strus::PatternLexemBatch input = getLexemBatch( doc);
+	std::vector<strus::analyzer::PatternMatcherResult> seqresults = processDocument( ptinst, doc);
+	std::vector<strus::analyzer::PatternMatcherResult> parresults;
+	if (!strus::matchPatternMatcherDocumentParallel( parresults, ptinst, input, 4, g_errorBuffer))
+	{
+		throw std::runtime_error( "error matching a document in parallel");
+	}
+	if (parresults.size() != seqresults.size())
+	{
+		throw std::runtime_error( "number of matches of a document matched in parallel differs from the sequential matching");
+	}
+	std::size_t pi = 0, pe = parresults.size();
+	for (; pi != pe; ++pi)
+	{
+		if (!isEqualResult( parresults[ pi], seqresults[ pi]))
+		{
+			throw std::runtime_error( "matches of a document matched in parallel differ from the sequential matching");
+		}
+	}
+}
+
+// Match a long document of the test document structure in parallel:
+static void testDocumentParallel( const strus::PatternMatcherInstanceInterface* ptinst, unsigned int documentSize)
+{
+	checkDocumentParallel( ptinst, createDocument( 100, documentSize * 400));
+}
+
+static const Pattern densePatterns[8] =
+{
+	{"seq[3]_1_2",
+		{{Operation::Term,TOKEN(1),1},
+		 {Operation::Term,TOKEN(2),2},
+		 {Operation::Expression,0,0,PT::OpSequence,3,0,2}},
+		{0}
+	},
+	{"seq[3]_2_3",
+		{{Operation::Term,TOKEN(2),1},
+		 {Operation::Term,TOKEN(3),2},
+		 {Operation::Expression,0,0,PT::OpSequence,3,0,2}},
+		{0}
+	},
+	{"seq[3]_3_1",
+		{{Operation::Term,TOKEN(3),1},
+		 {Operation::Term,TOKEN(1),2},
+		 {Operation::Expression,0,0,PT::OpSequence,3,0,2}},
+		{0}
+	},
+	{"seq[4]_1_2_3",
+		{{Operation::Term,TOKEN(1),1},
+		 {Operation::Term,TOKEN(2),2},
+		 {Operation::Term,TOKEN(3),3},
+		 {Operation::Expression,0,0,PT::OpSequence,4,0,3}},
+		{0}
+	},
+	{0,{Operation::None}}
+};
+
+// Match a document with the tokens 1,2,3 repeated, every pair of neighbour positions is covered by a match, so matches straddle every window boundary:
+static void testDenseDocumentParallel( const strus::PatternMatcherInterface* pt, unsigned int documentSize)
+{
+	std::auto_ptr<strus::PatternMatcherInstanceInterface> ptinst( pt->createInstance());
+	if (!ptinst.get()) throw std::runtime_error("failed to create pattern matcher instance");
+	createPatterns( ptinst.get(), densePatterns);
+	ptinst->compile();
+	if (g_errorBuffer->hasError())
+	{
+		throw std::runtime_error( "error creating automaton for evaluating rules");
+	}
+	Document doc( "dense");
+	unsigned int ii = 0, ie = documentSize * 400;
+	for (; ii < ie; ++ii)
+	{
+		doc.itemar.push_back( DocumentItem( ii+1, termId( Token, ii % 3 + 1)));
+	}
+	checkDocumentParallel( ptinst.get(), doc);
+}
+
 int main( int argc, const char** argv)
 {
 	try
@@ -255,15 +710,8 @@ int main( int argc, const char** argv)
 			results = processDocument( ptinst.get(), doc);
 
 		// Verify results:
-		std::vector<strus::analyzer::PatternMatcherResult>::const_iterator
-			ri = results.begin(), re = results.end();
-
-		typedef std::pair<std::string,unsigned int> Match;
-		std::set<Match> matches;
-		for (;ri != re; ++ri)
-		{
-			matches.insert( Match( ri->name(), ri->start_ordpos()));
-		}
+		std::set<Match> matches = getMatchSet( results);
+		std::set<Match> allMatches( matches);
 		std::set<Match>::const_iterator li = matches.begin(), le = matches.end();
 		for (; li != le; ++li)
 		{
@@ -299,6 +747,24 @@ int main( int argc, const char** argv)
 			}
 			throw std::runtime_error( "more matches found than expected");
 		}
+		std::cerr << "executing test term vocabulary" << std::endl;
+		testTermVocabulary( pt.get(), doc, allMatches);
+		std::cerr << "executing test binary image" << std::endl;
+		testImage( pt.get(), ptinst.get(), doc, allMatches);
+		std::cerr << "executing test binary image file" << std::endl;
+		testImageFile( pt.get(), ptinst.get(), doc, allMatches);
+		std::cerr << "executing test corrupt binary image" << std::endl;
+		testCorruptImage( pt.get(), ptinst.get());
+		std::cerr << "executing test binary image with corrupt indices" << std::endl;
+		testCorruptImageIndex( pt.get(), ptinst.get());
+		std::cerr << "executing test lexem array" << std::endl;
+		testLexemArray( ptinst.get(), doc, allMatches);
+		std::cerr << "executing test document batch" << std::endl;
+		testDocumentBatch( ptinst.get(), documentSize);
+		std::cerr << "executing test document matched in parallel" << std::endl;
+		testDocumentParallel( ptinst.get(), documentSize);
+		std::cerr << "executing test dense document matched in parallel" << std::endl;
+		testDenseDocumentParallel( pt.get(), documentSize);
 		if (g_errorBuffer->hasError())
 		{
 			throw std::runtime_error("error matching rule");
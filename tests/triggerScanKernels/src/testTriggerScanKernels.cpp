@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2014 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Test of the kernels scanning the event trigger table against each other
+#include "ruleMatcherAutomaton.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <vector>
+#include <ctime>
+
+#undef STRUS_LOWLEVEL_DEBUG
+
+static void initRand()
+{
+	time_t nowtime;
+	struct tm* now;
+
+	::time( &nowtime);
+	now = ::localtime( &nowtime);
+
+	::srand( ((now->tm_year+1) * (now->tm_mon+100) * (now->tm_mday+1)));
+}
+#define RANDINT(MIN,MAX) ((std::rand()%(MAX-MIN))+MIN)
+
+typedef strus::EventTriggerTable::TriggerRefList TriggerRefList;
+
+/// \brief Fill a trigger table with random events out of a small set, so that the hash buckets get long and most events fire many triggers
+/// \return the number of triggers defined per event (index is the event)
+static std::vector<unsigned int> fillRandomTriggerTable( strus::EventTriggerTable& tab, unsigned int nofTriggers, unsigned int nofEvents)
+{
+	std::vector<unsigned int> rt( nofEvents+1, 0);
+	std::vector<uint32_t> triggeridxar;
+	unsigned int ti = 0;
+	for (; ti < nofTriggers; ++ti)
+	{
+		uint32_t event = RANDINT(1,nofEvents+1);
+		strus::Trigger trigger( ti+1, strus::Trigger::SigAny, 0, 0);
+		triggeridxar.push_back( tab.add( strus::EventTrigger( event, trigger)));
+		++rt[ event];
+	}
+	// Remove some triggers, so that the event arrays get entries moved by the removal:
+	unsigned int ri = 0, re = nofTriggers / 3;
+	for (; ri < re; ++ri)
+	{
+		std::size_t pos = RANDINT(0,triggeridxar.size());
+		uint32_t triggeridx = triggeridxar[ pos];
+		--rt[ tab.getTriggerEventId( triggeridx)];
+		tab.remove( triggeridx);
+		triggeridxar[ pos] = triggeridxar.back();
+		triggeridxar.pop_back();
+	}
+	return rt;
+}
+
+static void testScanKernels( unsigned int nofTriggers, unsigned int nofEvents)
+{
+	strus::EventTriggerTable tab;
+	std::vector<unsigned int> expected = fillRandomTriggerTable( tab, nofTriggers, nofEvents);
+
+	uint32_t event = 1;
+	for (; event <= nofEvents + 1; ++event)
+	{
+		TriggerRefList reference;
+		tab.getTriggers( reference, event, strus::EventTriggerTable::ScanScalar);
+		std::size_t expectedSize = event <= nofEvents ? expected[ event] : 0;
+		if (reference.size() != expectedSize)
+		{
+			std::ostringstream msg;
+			msg << "scalar trigger scan of event " << event << " returns " << reference.size() << " triggers instead of " << expectedSize;
+			throw std::runtime_error( msg.str());
+		}
+		int ki = 0;
+		for (; ki <= strus::EventTriggerTable::NofScanKernels; ++ki)
+		{
+			TriggerRefList triggers;
+			const char* kernelName = "selected";
+			if (ki == strus::EventTriggerTable::NofScanKernels)
+			{
+				tab.getTriggers( triggers, event);
+			}
+			else
+			{
+				strus::EventTriggerTable::ScanKernel kernel = (strus::EventTriggerTable::ScanKernel)ki;
+				if (!strus::EventTriggerTable::scanKernelSupported( kernel)) continue;
+				kernelName = strus::EventTriggerTable::scanKernelName( kernel);
+				tab.getTriggers( triggers, event, kernel);
+			}
+			if (triggers.size() != reference.size())
+			{
+				std::ostringstream msg;
+				msg << "trigger scan kernel " << kernelName << " returns " << triggers.size() << " triggers instead of " << reference.size() << " for event " << event << " (" << nofTriggers << " triggers, " << nofEvents << " events)";
+				throw std::runtime_error( msg.str());
+			}
+			std::size_t ti = 0, te = reference.size();
+			for (; ti != te; ++ti)
+			{
+				if (triggers[ ti] != reference[ ti])
+				{
+					std::ostringstream msg;
+					msg << "trigger scan kernel " << kernelName << " returns trigger " << triggers[ ti]->slot() << " instead of " << reference[ ti]->slot() << " at position " << ti << " for event " << event << " (" << nofTriggers << " triggers, " << nofEvents << " events)";
+					throw std::runtime_error( msg.str());
+				}
+			}
+		}
+	}
+}
+
+int main( int argc, const char** argv)
+{
+	try
+	{
+		initRand();
+		int ki = 0;
+		for (; ki < strus::EventTriggerTable::NofScanKernels; ++ki)
+		{
+			strus::EventTriggerTable::ScanKernel kernel = (strus::EventTriggerTable::ScanKernel)ki;
+			std::cerr << "trigger scan kernel " << strus::EventTriggerTable::scanKernelName( kernel)
+					<< (strus::EventTriggerTable::scanKernelSupported( kernel) ? " supported" : " not supported") << std::endl;
+		}
+		// Table sizes chosen to cover the remainders of the 16, 32 and 64 word blocks of the vectorized kernels:
+		static const unsigned int nofTriggersAr[] = {0,1,15,16,17,31,33,63,64,65,129,1000,5000,20000,0};
+		static const unsigned int nofEventsAr[] = {1,3,40,1000,0};
+		unsigned int ni = 0;
+		for (; nofTriggersAr[ni] || ni == 0; ++ni)
+		{
+			unsigned int ei = 0;
+			for (; nofEventsAr[ei]; ++ei)
+			{
+				testScanKernels( nofTriggersAr[ni], nofEventsAr[ei]);
+			}
+		}
+		std::cerr << "OK" << std::endl;
+		return 0;
+	}
+	catch (const std::runtime_error& err)
+	{
+		std::cerr << "error: " << err.what() << std::endl;
+	}
+	catch (const std::bad_alloc& )
+	{
+		std::cerr << "out of memory" << std::endl;
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << "exception: " << err.what() << std::endl;
+	}
+	return -1;
+}
+